@@ -0,0 +1,48 @@
+#pragma once
+
+// stl
+#include <optional>
+#include <string_view>
+
+// nlohmann
+#include <nlohmann/json_fwd.hpp>
+
+namespace wr22::regex_executor {
+
+/// The matching algorithms (engines) available in this library.
+enum class Algorithm {
+    /// Backtracking over the regex program (`algorithms::backtracking`). The only algorithm
+    /// that records the steps of the matching process. May take exponential time.
+    Backtracking,
+    /// Thompson NFA simulation (`algorithms::pike_vm`). Takes `O(n·m)` time, where `n` is the
+    /// length of the string and `m` is the size of the regex program. Keeps a single thread per
+    /// instruction, so when a group repeats something that can match the empty string, the
+    /// captures and even the match span may differ from the ones `Backtracking` finds (e.g.
+    /// `((?:(?:)*|b))+` searched in "b" matches `0..0` rather than `0..1`).
+    PikeVm,
+    /// Lazily built DFA (`algorithms::lazy_dfa`). Only reports whether the string matches, without
+    /// captures. Falls back to `PikeVm` if the regex makes the DFA state cache thrash, or if
+    /// all the matches are requested (`Fragment::All`).
+    LazyDfa,
+    /// One-pass DFA (`algorithms::one_pass`). Reports captures after a single scan of the
+    /// string, but only applies to one-pass regexes matched against whole strings; falls back
+    /// to `PikeVm` otherwise, with the same caveat about empty iterations.
+    OnePass,
+    /// Bit-parallel simulation of the position automaton (`algorithms::bit_parallel`). Only
+    /// reports whether the string matches, like `LazyDfa`, but needs no cache: a few bitwise
+    /// operations per character. Only applies to regexes with at most 63 characters to match
+    /// (literals, classes and wildcards); falls back to `LazyDfa` otherwise, and to `PikeVm` if
+    /// all the matches are requested (`Fragment::All`).
+    BitParallel,
+};
+
+/// Get the name of an algorithm as used in the `/match` interface.
+const char* algorithm_name(Algorithm algorithm);
+
+/// Get an algorithm by its name (see `algorithm_name`), or `std::nullopt` if there is no
+/// algorithm with this name.
+std::optional<Algorithm> algorithm_from_name(std::string_view name);
+
+void to_json(nlohmann::json& j, Algorithm algorithm);
+
+}  // namespace wr22::regex_executor
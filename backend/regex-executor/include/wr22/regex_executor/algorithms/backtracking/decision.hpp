@@ -1,49 +1,73 @@
 #pragma once
 
 // wr22
-//#include <wr22/regex_executor/algorithms/backtracking/interpreter_state.hpp>
-#include <wr22/regex_parser/regex/part.hpp>
+#include <wr22/utils/adt.hpp>
 
 // stl
-#include <functional>
+#include <cstddef>
 #include <optional>
 
 namespace wr22::regex_executor::algorithms::backtracking {
 
-struct Interpreter;
+class Interpreter;
 struct InterpreterStateSnapshot;
 
+/// A decision made by the `program::instruction::Alternatives` instruction at `pc`: the
+/// alternative with the index `alternative_index` is being tried.
 struct AlternativesDecision {
-    using PartType = regex_parser::regex::part::Alternatives;
-
-    // SAFETY: comes from borrowed `regex`, safe to keep as long
-    // as the `Executor` is alive, provided its safety assumptions
-    // are met.
-    std::reference_wrapper<const PartType> part_ref;
-    std::optional<size_t> initial_string_pos;
-    size_t decision_index = 0;
-
-    std::optional<AlternativesDecision> reconsider(
-        Interpreter& interpreter,
-        InterpreterStateSnapshot snapshot) const;
+    size_t pc;
+    size_t alternative_index = 0;
+
+    /// Try the next alternative, if any. Returns whether the decision has been reconsidered.
+    bool reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot) const;
+    /// Called when the decision cannot be reconsidered anymore.
+    void finalize_exhausted(Interpreter& interpreter) const;
 };
 
-template <typename PartT>
+/// A decision made by a quantifier (begun at `quantifier_pc`) to match one more repetition.
 struct QuantifierDecision {
-    using PartType = PartT;
-
-    bool stop_here = false;
-    bool can_go_back = false;
+    size_t quantifier_pc;
+    /// Where to continue if the quantifier stops before this repetition, or `std::nullopt` if
+    /// stopping here would violate the minimum number of repetitions.
+    std::optional<size_t> exit_pc;
+    /// Whether this is the decision to match the first repetition.
     bool is_first = false;
-    std::optional<QuantifierDecision<PartT>> reconsider(
-        Interpreter& interpreter,
-        InterpreterStateSnapshot snapshot) const;
+
+    /// Stop repeating, if allowed. Returns whether the decision has been reconsidered.
+    bool reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot) const;
+    /// Called when the decision cannot be reconsidered anymore.
+    void finalize_exhausted(Interpreter& interpreter) const;
+};
+
+/// A decision made by a quantifier with a single-character body (`QuantifierSplit` at
+/// `split_pc`) that has matched a whole run of characters at once and has stopped repeating
+/// at the current position. It stands for all the shorter runs that have not been tried yet:
+/// reconsidering it gives back characters until the quantifier may stop there, but not before
+/// `min_end`, where the run has begun.
+struct RunDecision {
+    size_t split_pc;
+    size_t min_end;
+
+    /// Stop at the last earlier position where stopping may lead to a match, if any. Returns
+    /// whether the decision has been reconsidered.
+    bool reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot) const;
+    /// Called when the decision cannot be reconsidered anymore.
+    void finalize_exhausted(Interpreter& interpreter) const;
+};
+
+/// Not a real decision, but a mark placed by memoized backtracking under the decision made at
+/// a decision point. Once it is reached while backtracking, everything explored after the
+/// decision point has failed, so the entry `bit` of the memoization table is set.
+struct FailureMark {
+    size_t bit;
+
+    /// Never succeeds: there are no options to try.
+    bool reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot) const;
+    /// Called when the decision cannot be reconsidered anymore.
+    void finalize_exhausted(Interpreter& interpreter) const;
 };
 
-using Decision = wr22::utils::Adt<
-    AlternativesDecision,
-    QuantifierDecision<regex_parser::regex::part::Star>,
-    QuantifierDecision<regex_parser::regex::part::Plus>,
-    QuantifierDecision<regex_parser::regex::part::Optional>>;
+using Decision =
+    wr22::utils::Adt<AlternativesDecision, QuantifierDecision, RunDecision, FailureMark>;
 
 }  // namespace wr22::regex_executor::algorithms::backtracking
@@ -1,12 +0,0 @@
-#pragma once
-
-// stl
-#include <cstddef>
-
-namespace wr22::regex_executor::algorithms::backtracking {
-
-struct DecisionRef {
-    size_t index;
-};
-
-}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -2,6 +2,9 @@
 
 // wr22
 #include <wr22/regex_executor/algorithms/backtracking/match_result.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/match_scratch.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step_sink.hpp>
+#include <wr22/regex_executor/match_options.hpp>
 #include <wr22/regex_executor/regex.hpp>
 
 // stl
@@ -10,15 +13,31 @@
 
 namespace wr22::regex_executor::algorithms::backtracking {
 
+/// Matches strings with the backtracking algorithm.
+///
+/// The buffers the algorithm works in are kept between `execute()` calls (see `MatchScratch`),
+/// so an executor must not be used from several threads at once.
 class Executor {
 public:
     explicit Executor(const Regex& regex_ref);
 
     const Regex& regex_ref() const;
-    MatchResult execute(const std::u32string_view& string) const;
+    MatchResult execute(const std::u32string_view& string, const MatchOptions& options = {});
+    /// Match a string, passing the steps to `step_sink` as soon as they are made instead of
+    /// collecting them into `MatchResult::steps`. `MatchOptions::record_steps` is ignored.
+    MatchResult execute(
+        const std::u32string_view& string,
+        const MatchOptions& options,
+        StepSink& step_sink);
 
 private:
+    MatchResult execute_into(
+        const std::u32string_view& string,
+        const MatchOptions& options,
+        StepSink* step_sink);
+
     std::reference_wrapper<const Regex> m_regex_ref;
+    MatchScratch m_scratch;
 };
 
 }  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,44 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/interpreter.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+
+// stl
+#include <cstddef>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+/// Executes a single program instruction located at `pc` on behalf of an `Interpreter`.
+///
+/// Before an instruction is executed, the interpreter's program counter is already set to
+/// `pc + 1`, so the instructions that do not jump need not touch it. Each call operator returns
+/// `false` if matching has failed and the interpreter has to backtrack, and `true` otherwise.
+class InstructionExecutor {
+public:
+    InstructionExecutor(Interpreter& interpreter, size_t pc);
+
+    bool operator()(const program::instruction::Literal& instruction) const;
+    bool operator()(const program::instruction::Wildcard& instruction) const;
+    bool operator()(const program::instruction::CharClass& instruction) const;
+    bool operator()(const program::instruction::Alternatives& instruction) const;
+    bool operator()(const program::instruction::FinishAlternative& instruction) const;
+    bool operator()(const program::instruction::BeginGroup& instruction) const;
+    bool operator()(const program::instruction::EndGroup& instruction) const;
+    bool operator()(const program::instruction::BeginQuantifier& instruction) const;
+    bool operator()(const program::instruction::QuantifierSplit& instruction) const;
+    bool operator()(const program::instruction::EndIteration& instruction) const;
+    bool operator()(const program::instruction::EndQuantifier& instruction) const;
+    bool operator()(const program::instruction::Match& instruction) const;
+
+private:
+    /// Match all the repetitions of a quantifier with `QuantifierSplit::single_char_body` at
+    /// once, without recording the steps.
+    bool match_run(const program::instruction::QuantifierSplit& instruction) const;
+    regex_parser::span::Span regex_span() const;
+
+    Interpreter& m_interpreter;
+    size_t m_pc;
+};
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
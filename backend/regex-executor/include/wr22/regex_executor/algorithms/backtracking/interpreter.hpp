@@ -1,17 +1,21 @@
 #pragma once
 
 // wr22
-#include <wr22/regex_executor/algorithms/backtracking/decision_ref.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/decision.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/decision_snapshot.hpp>
-#include <wr22/regex_executor/algorithms/backtracking/instruction.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/interpreter_state.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/match_scratch.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step_sink.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/trail.hpp>
+#include <wr22/regex_executor/match_budget.hpp>
+#include <wr22/regex_executor/match_options.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+#include <wr22/regex_executor/program/start_filter.hpp>
 #include <wr22/regex_executor/regex.hpp>
-#include <wr22/regex_parser/regex/part.hpp>
 
 // stl
-#include <functional>
-#include <stack>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -19,60 +23,118 @@ namespace wr22::regex_executor::algorithms::backtracking {
 
 class Interpreter {
 public:
-    Interpreter(const Regex& regex, const std::u32string_view& string_ref);
+    /// Create an interpreter that passes the steps it makes to `step_sink`, or does not record
+    /// any steps if it is null. `MatchOptions::record_steps` is not taken into account. The
+    /// interpreter works in the buffers of `scratch`, which must outlive it.
+    Interpreter(
+        const Regex& regex,
+        const std::u32string_view& string_ref,
+        const MatchOptions& options,
+        StepSink* step_sink,
+        MatchScratch& scratch);
+
+    const program::Program& program() const;
 
     std::optional<char32_t> current_char() const;
-    void advance();
-
-    DecisionRef add_decision(
-        Decision decision,
-        utils::SpannedRef<regex_parser::regex::Part> decision_making_part);
-    const DecisionSnapshot& decision_snapshot_at(DecisionRef ref) const;
-    DecisionSnapshot& decision_snapshot_at(DecisionRef ref);
-    std::optional<DecisionRef> last_decision_ref() const;
-    void restore_from_snapshot(InterpreterStateSnapshot snapshot);
+    void advance(size_t count = 1);
+    /// Count the consecutive characters from the cursor on, up to `max_length` of them, that
+    /// are matched by the instruction at `pc`, which must be a literal, a wildcard or a character
+    /// class.
+    size_t run_length(size_t pc, size_t max_length = std::u32string_view::npos) const;
+    /// If the rest of the string starts with `literal`, advance past it and return true.
+    bool consume(std::u32string_view literal);
+    size_t cursor() const;
+    size_t string_length() const;
+    /// Whether a match may end before the end of the string (see `Fragment`).
+    bool searching() const;
 
-    void push_mini_snapshot();
-    void pop_mini_snapshot();
-    std::optional<std::reference_wrapper<const InterpreterStateMiniSnapshot>> last_mini_snapshot()
-        const;
+    size_t pc() const;
+    void jump(size_t pc);
 
-    void add_instruction(Instruction instruction);
-    void add_step(Step step);
+    void add_decision(Decision decision);
+    void restore_from_snapshot(InterpreterStateSnapshot snapshot);
 
-    void push_error_hook(ErrorHook hook);
-    void pop_error_hook();
-    const ErrorHook& last_error_hook() const;
-    ErrorHook& last_error_hook();
+    /// Called when the decision point at `pc` is reached. Returns false if it is known to fail
+    /// at the current position, which means that the path being explored cannot lead to a
+    /// match. Otherwise, arranges for the (decision point, position) pair to be marked as failed
+    /// once everything explored from here on has failed. Always returns true if memoization is
+    /// disabled.
+    bool enter_decision_point(size_t pc);
+    /// Set the entry `bit` of the memoization table (see `FailureMark`).
+    void mark_failed(size_t bit);
+    /// Whether the decision points reached at each position are remembered.
+    bool memoizes() const;
+
+    /// Check whether the quantifier that `split` belongs to may stop repeating at `position`
+    /// and still lead to a match, judging by `QuantifierSplit::exit_follow`.
+    bool may_exit(const program::instruction::QuantifierSplit& split, size_t position) const;
+
+    bool records_steps() const;
+    void add_step(Step step);
 
-    void push_counter(size_t initial);
-    void pop_counter();
-    size_t& counter_at_offset(size_t offset);
-    size_t counter_at_offset(size_t offset) const;
+    size_t register_at(size_t index) const;
+    void set_register(size_t index, size_t value);
 
-    size_t cursor() const;
     bool finished() const;
+    void finish();
 
+    /// Run the instruction at the current program counter.
+    ///
+    /// @throws `BudgetExceeded` if the budget from the `MatchOptions` has been exceeded.
     void run_instruction();
     void finalize();
     void finalize_error();
+    /// After a match has been found, start searching for the next one, which does not overlap
+    /// with it. Returns false if there are no more positions to search at.
+    bool resume_after_match();
 
-    void add_indexed_capture(Capture capture);
-    void add_named_capture(std::string_view name, Capture capture);
-
-    std::vector<Step> into_steps() &&;
+    /// Record a capture in a capture slot (see `program::Program::capture_slots`).
+    void set_capture(size_t slot, size_t begin, size_t end);
+    /// Build the captures of the match that has been found.
+    Captures captures() const;
 
     const InterpreterState& current_state() const;
     InterpreterState& current_state();
 
 private:
-    size_t parse_counter_offset(size_t offset) const;
-
+    void backtrack();
+    /// Whether one of the unbounded quantifiers enclosing `decision_point` would reject its
+    /// current repetition if it ended without consuming more characters. A failure found in
+    /// such a state depends on the registers, not only on the position, and is not memoized.
+    bool may_reject_empty_iteration(const DecisionPoint& decision_point) const;
+    void check_budget();
+    size_t memory_usage() const;
+    /// Start matching anew at the next position a match can start at, if the regex is being
+    /// searched for. Returns false if there are no more positions to try.
+    bool restart_at_next_candidate();
+    void start_at(size_t position);
+
+    bool trail_active() const;
+    void record(TrailEntry entry);
+    void unwind_trail(size_t mark);
+
+    const program::Program& m_program;
+    const program::StartFilter& m_start_filter;
     std::u32string_view m_string_ref;
-    InterpreterState m_current_state;
-    std::vector<DecisionSnapshot> m_decision_snapshots;
-    std::stack<InterpreterStateMiniSnapshot> m_mini_snapshots;
-    std::vector<Step> m_steps;
+    StepSink* m_step_sink;
+    size_t m_num_steps = 0;
+    bool m_searching;
+    /// The position the current attempt to match has started at.
+    size_t m_start = 0;
+    bool m_finished = false;
+    /// For each instruction, what memoization needs to know about it if it is a decision point,
+    /// or `std::nullopt` for the other instructions. Empty if memoization is disabled.
+    std::vector<std::optional<DecisionPoint>>& m_decision_points;
+    std::vector<size_t>& m_enclosing_quantifiers;
+    /// `(string length + 1)` bits per decision point: whether it is known to fail at a given
+    /// position.
+    std::vector<bool>& m_failed;
+    InterpreterState& m_current_state;
+    std::vector<TrailEntry>& m_trail;
+    std::vector<DecisionSnapshot>& m_decision_snapshots;
+    MatchBudget m_budget;
+    MatchStatistics m_statistics;
+    size_t m_instructions_until_check = MatchBudget::check_interval;
 };
 
 }  // namespace wr22::regex_executor::algorithms::backtracking
@@ -1,32 +1,30 @@
 #pragma once
 
-// wr22
-#include <wr22/regex_executor/algorithms/backtracking/error_hook.hpp>
-#include <wr22/regex_executor/algorithms/backtracking/instruction.hpp>
-#include <wr22/regex_executor/capture.hpp>
-
 // stl
-#include <stack>
+#include <cstddef>
 #include <vector>
 
 namespace wr22::regex_executor::algorithms::backtracking {
 
 struct InterpreterState {
     size_t cursor = 0;
-    std::vector<Instruction> instructions;
-    std::stack<ErrorHook> error_hooks;
-    std::vector<size_t> counters;
-    Captures captures;
-    size_t capture_counter = 1;
+    /// The index of the program instruction to be executed next.
+    size_t pc = 0;
+    /// Values of the program registers (see `program::Program::num_registers`).
+    std::vector<size_t> registers;
+    /// The beginning and the end of the latest capture recorded in each capture slot (see
+    /// `program::Program::capture_slots`), or `program::unset_capture_position`.
+    std::vector<size_t> capture_positions;
 };
 
+/// A lightweight snapshot of `InterpreterState`.
+///
+/// Instead of copying the whole state, only the scalar parts of it are stored along with
+/// the length of the interpreter's trail at the moment the snapshot was taken. Everything else
+/// is restored by unwinding the trail back to this mark. The program counter is not stored,
+/// since a reconsidered decision always jumps to a new location.
 struct InterpreterStateSnapshot {
-    InterpreterState state;
-    utils::SpannedRef<regex_parser::regex::Part> decision_making_part;
-    size_t before_step;
-};
-
-struct InterpreterStateMiniSnapshot {
+    size_t trail_mark;
     size_t cursor;
     size_t before_step;
 };
@@ -16,7 +16,12 @@ namespace wr22::regex_executor::algorithms::backtracking {
 struct MatchResult {
     bool matched;
     std::optional<Captures> captures;
-    std::vector<Step> steps;
+    /// The captures of every match, if all the matches have been requested with
+    /// `Fragment::All`. `captures` then holds the first of them.
+    std::optional<std::vector<Captures>> matches;
+    /// The steps made during matching. `std::nullopt` if recording steps was disabled
+    /// by `MatchOptions::record_steps`.
+    std::optional<std::vector<Step>> steps;
 };
 
 void to_json(nlohmann::json& j, const MatchResult& result);
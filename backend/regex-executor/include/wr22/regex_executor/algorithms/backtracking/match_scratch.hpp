@@ -0,0 +1,40 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/decision_snapshot.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/interpreter_state.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/trail.hpp>
+
+// stl
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+/// What memoization needs to know about a decision point.
+struct DecisionPoint {
+    /// The index of the decision point among all of them.
+    size_t index;
+    /// The unbounded quantifiers the body of which contains the decision point, as the range
+    /// `[quantifiers_begin, quantifiers_end)` of `MatchScratch::enclosing_quantifiers`.
+    size_t quantifiers_begin;
+    size_t quantifiers_end;
+};
+
+/// The buffers the interpreter works in.
+///
+/// They are kept between runs, so that matching many short strings in a row does not allocate
+/// them anew every time. An `Interpreter` resets them when it takes them over, keeping their
+/// capacity; their contents mean nothing outside of a run.
+struct MatchScratch {
+    InterpreterState state;
+    std::vector<TrailEntry> trail;
+    std::vector<DecisionSnapshot> decision_snapshots;
+    std::vector<std::optional<DecisionPoint>> decision_points;
+    /// The program counters of `program::instruction::BeginQuantifier` instructions.
+    std::vector<size_t> enclosing_quantifiers;
+    std::vector<bool> failed;
+};
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,86 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step_sink.hpp>
+#include <wr22/regex_parser/span/span.hpp>
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json_fwd.hpp>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+/// A step sink that packs the steps into a compact binary log.
+///
+/// Each step is encoded as a tag byte, which tells the type of the step and the outcome it
+/// records, followed by its fields as variable-length integers. Regex spans, which repeat a lot,
+/// are stored once in a table and referred to by their index, and the target of a
+/// `step::Backtrack` is stored relative to the step itself. A typical step thus takes a few bytes
+/// instead of the size of `Step`.
+///
+/// The steps are expanded back into `Step`s one at a time while iterating over the log.
+class StepLog final : public StepSink {
+public:
+    /// An input iterator over the steps of a log, which decodes each step as it reaches it.
+    class ConstIterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Step;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Step*;
+        using reference = const Step&;
+
+        const Step& operator*() const;
+        const Step* operator->() const;
+        ConstIterator& operator++();
+        bool operator==(const ConstIterator& other) const;
+
+    private:
+        friend class StepLog;
+        ConstIterator(const StepLog& log, size_t offset);
+        void decode();
+
+        const StepLog* m_log;
+        size_t m_offset;
+        size_t m_next_offset;
+        size_t m_index = 0;
+        std::optional<Step> m_current;
+    };
+
+    void consume(Step step) override;
+    size_t memory_usage() const override;
+
+    /// The number of steps in the log.
+    size_t size() const;
+    bool empty() const;
+    ConstIterator begin() const;
+    ConstIterator end() const;
+
+    /// Expand the whole log into a vector of steps.
+    std::vector<Step> to_steps() const;
+
+private:
+    struct SpanHash {
+        size_t operator()(const regex_parser::span::Span& span) const;
+    };
+
+    uint32_t regex_span_index(const regex_parser::span::Span& span);
+
+    std::vector<uint8_t> m_bytes;
+    size_t m_size = 0;
+    std::vector<regex_parser::span::Span> m_regex_spans;
+    std::unordered_map<regex_parser::span::Span, uint32_t, SpanHash> m_regex_span_indices;
+};
+
+/// Serialize the steps of a log into a JSON array, the same way a vector of them is serialized.
+void to_json(nlohmann::json& j, const StepLog& log);
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,70 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+
+// stl
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+/// Receives the steps of the backtracking algorithm one by one, as soon as they are made.
+///
+/// The steps are passed in order. Since a `step::Backtrack` refers to an earlier step by its
+/// index, a sink that needs to resolve these references has to keep track of the steps itself.
+class StepSink {
+public:
+    virtual ~StepSink() = default;
+
+    /// Receive the next step.
+    virtual void consume(Step step) = 0;
+
+    /// The memory held by the sink, in bytes. It counts towards `MatchBudget::max_memory`.
+    virtual size_t memory_usage() const;
+};
+
+/// Collects the steps into a vector.
+class VectorStepSink final : public StepSink {
+public:
+    void consume(Step step) override;
+    size_t memory_usage() const override;
+
+    const std::vector<Step>& steps() const;
+    std::vector<Step> into_steps() &&;
+
+private:
+    std::vector<Step> m_steps;
+};
+
+/// Only counts the steps, discarding them.
+class CountingStepSink final : public StepSink {
+public:
+    void consume(Step step) override;
+
+    size_t num_steps() const;
+
+private:
+    size_t m_num_steps = 0;
+};
+
+/// Writes the steps to an output stream as a JSON array, in the same format as
+/// `MatchResult::steps` is serialized in.
+///
+/// The opening bracket is written on construction. `finish` must be called after matching to
+/// close the array.
+class JsonStepSink final : public StepSink {
+public:
+    explicit JsonStepSink(std::ostream& out);
+
+    void consume(Step step) override;
+    /// Close the JSON array.
+    void finish();
+
+private:
+    std::ostream& m_out;
+    bool m_empty = true;
+};
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,36 @@
+#pragma once
+
+// wr22
+#include <wr22/utils/adt.hpp>
+
+// stl
+#include <cstddef>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+/// Entries of the interpreter's trail (undo log).
+///
+/// Every mutation of `InterpreterState` made while at least one decision is alive records
+/// an entry that describes how to revert this mutation. Restoring a decision snapshot then
+/// amounts to applying the entries recorded after the snapshot was taken in reverse order.
+namespace trail_entry {
+    /// Revert assigning a new value to the register with a given index.
+    struct SetRegister {
+        size_t index;
+        size_t value;
+    };
+
+    /// Revert recording a capture in the capture slot with a given index. `begin` and `end` are
+    /// the positions recorded in the slot before.
+    struct SetCapture {
+        size_t slot;
+        size_t begin;
+        size_t end;
+    };
+
+    using Adt = wr22::utils::Adt<SetRegister, SetCapture>;
+}  // namespace trail_entry
+
+using TrailEntry = trail_entry::Adt;
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
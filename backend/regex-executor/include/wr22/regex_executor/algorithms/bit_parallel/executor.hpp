@@ -0,0 +1,34 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/bit_parallel/match_result.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace wr22::regex_executor::algorithms::bit_parallel {
+
+/// Matches strings by simulating the position automaton of a short regex (see
+/// `PositionAutomaton`) with bitwise operations on a single word.
+///
+/// Each character takes a few table lookups and bitwise operations, and nothing is allocated
+/// while matching, so the executor holds no state of its own. When searching, the initial state
+/// is added back after every character, which starts a match at every position at once.
+/// `Fragment::All` is answered like `Fragment::Search`: the string matches if it has any match.
+class Executor {
+public:
+    explicit Executor(const Regex& regex_ref);
+
+    const Regex& regex_ref() const;
+    /// Match a string, returning `std::nullopt` if the regex has too many positions.
+    std::optional<MatchResult> execute(const std::u32string_view& string, Fragment fragment) const;
+
+private:
+    std::reference_wrapper<const Regex> m_regex_ref;
+};
+
+}  // namespace wr22::regex_executor::algorithms::bit_parallel
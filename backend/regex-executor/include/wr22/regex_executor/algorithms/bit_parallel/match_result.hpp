@@ -0,0 +1,11 @@
+#pragma once
+
+namespace wr22::regex_executor::algorithms::bit_parallel {
+
+/// The bit-parallel algorithm only answers whether a string matches: it never reports captures
+/// or steps.
+struct MatchResult {
+    bool matched;
+};
+
+}  // namespace wr22::regex_executor::algorithms::bit_parallel
@@ -0,0 +1,69 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_parser/regex/part.hpp>
+
+// stl
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::bit_parallel {
+
+/// A set of states of a `PositionAutomaton`, one bit per state.
+using StateSet = uint64_t;
+
+/// The Glushkov (position) automaton of a regex, with its state sets packed into a single word.
+///
+/// Every character-consuming leaf of the regex tree (a literal, a character class or a
+/// wildcard) is a position, and the state of the automaton is the set of positions that have
+/// consumed the last character, plus the initial state, in which nothing has been consumed yet.
+/// Bit 0 stands for the initial state and bit `i` for the `i`-th position from the left, so a
+/// regex fits if it has at most 63 positions.
+///
+/// A step over a character then takes two parts: the union of the `follow` sets of the current
+/// states, which is looked up in precomputed tables one byte of the state set at a time, and the
+/// intersection with the mask of the positions that can consume the character.
+class PositionAutomaton {
+public:
+    static constexpr StateSet initial_state = 1;
+    static constexpr size_t max_positions = 63;
+
+    /// Build the automaton for a regex, or return `std::nullopt` if it has more than
+    /// `max_positions` positions.
+    static std::optional<PositionAutomaton> build(
+        const regex_parser::regex::SpannedPart& root_part);
+
+    /// The states that the automaton can go to from any of `states` by consuming some character.
+    StateSet follow(StateSet states) const;
+    /// The positions that can consume a character.
+    StateSet mask(char32_t c) const;
+    /// The states in which the regex has matched: the last positions, and the initial state if
+    /// the regex matches the empty string.
+    StateSet accepting_states() const;
+
+private:
+    /// A part of the `char32_t` range whose characters are consumed by the same positions.
+    struct CharRange {
+        char32_t first;
+        StateSet mask;
+    };
+
+    PositionAutomaton() = default;
+    /// Look up the mask of a character in `m_char_ranges`.
+    StateSet range_mask(char32_t c) const;
+
+    /// `follow` of every value of each byte of a state set, for as many bytes as there are
+    /// states.
+    std::vector<std::array<StateSet, 256>> m_follow_tables;
+    /// Precomputed masks of ASCII characters.
+    std::array<StateSet, 128> m_ascii_masks = {};
+    /// The ranges covering all the characters, in ascending order. `mask` falls back to these for
+    /// non-ASCII characters.
+    std::vector<CharRange> m_char_ranges;
+    StateSet m_accepting_states = 0;
+};
+
+}  // namespace wr22::regex_executor::algorithms::bit_parallel
@@ -0,0 +1,37 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// A partition of all the characters into equivalence classes with respect to a program.
+///
+/// Two characters belong to the same class if every instruction of the program either
+/// consumes both of them or neither. The DFA transition table then needs only one column per
+/// class instead of one per character. Each class is a contiguous range of characters.
+class Alphabet {
+public:
+    explicit Alphabet(const program::Program& program);
+    /// Partition the characters with respect to all of the `programs` at once.
+    explicit Alphabet(std::span<const program::Program* const> programs);
+
+    size_t num_classes() const;
+    size_t class_of(char32_t c) const;
+    /// Get some character belonging to a class.
+    char32_t representative(size_t class_index) const;
+
+private:
+    /// The first character of each class, in ascending order. Always starts with 0.
+    std::vector<char32_t> m_class_starts;
+    /// Precomputed classes of ASCII characters.
+    std::array<size_t, 128> m_ascii_classes;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
@@ -0,0 +1,29 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// The outcome of running the lazy DFA over a chunk of a string (see `Executor::run_chunk`).
+///
+/// DFA states are identified by their program counters rather than by `StateId`s, since the
+/// latter are only meaningful within the cache of one executor.
+struct ChunkRun {
+    /// The program counters of the state reached at the end of the chunk, or at the position
+    /// where the run has stopped.
+    std::vector<size_t> end_pcs;
+    /// Whether an accepting state has been reached while searching. The run stops there.
+    bool accepted = false;
+    /// The program counters of the states reached after every `checkpoint_interval` characters,
+    /// until the end of the chunk or the dead state.
+    std::vector<std::vector<size_t>> checkpoints;
+    /// The index of the first expected checkpoint the run has reached the same state at, if
+    /// any. The run stops there, since it would go on exactly as the run the expected
+    /// checkpoints come from.
+    std::optional<size_t> converged_at;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
@@ -0,0 +1,96 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/alphabet.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/chunk_run.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/match_result.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/state_cache.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/sparse_set.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// Matches strings with a DFA that is determinized from the regex program on demand.
+///
+/// Each DFA state and transition is computed the first time it is needed and then cached,
+/// so in the common case matching takes one table lookup per input character. The cache
+/// persists across `execute()` calls and is bounded by `cache_capacity` bytes; when it is
+/// full, it is cleared and rebuilt. If that happens too often for the cache to pay off,
+/// matching gives up, and the caller is expected to fall back to an NFA-based algorithm.
+///
+/// The kind of fragment to match is fixed at construction, since it changes the transitions.
+/// When searching, every state also contains the threads that start matching at the current
+/// position, and matching stops as soon as an accepting state is reached.
+class Executor {
+public:
+    static constexpr size_t default_cache_capacity = 2 * 1024 * 1024;
+
+    explicit Executor(
+        const Regex& regex_ref,
+        Fragment fragment = Fragment::Whole,
+        size_t cache_capacity = default_cache_capacity);
+
+    const Regex& regex_ref() const;
+    /// Match a string, returning `std::nullopt` if the state cache thrashes.
+    std::optional<MatchResult> execute(const std::u32string_view& string);
+
+    /// Run the DFA over a chunk of a string from the state with the threads at `start_pcs`,
+    /// recording the state after every `checkpoint_interval` characters. If
+    /// `expected_checkpoints` are given, the run stops as soon as it reaches one of them at the
+    /// same position instead. Returns `std::nullopt` if the state cache thrashes.
+    ///
+    /// Unlike `execute()`, neither starts nor ends the matching: the start filter is not used,
+    /// and whether the chunk ends in an accepting state is up to the caller.
+    std::optional<ChunkRun> run_chunk(
+        const std::u32string_view& chunk,
+        const std::vector<size_t>& start_pcs,
+        size_t checkpoint_interval,
+        const std::vector<std::vector<size_t>>* expected_checkpoints = nullptr);
+    /// The program counters of the state matching starts in.
+    const std::vector<size_t>& start_pcs() const;
+    /// The program counters of all the instructions a DFA state may have: a superset of every
+    /// state.
+    const std::vector<size_t>& all_pcs() const;
+    /// Check whether the state with the threads at `pcs` is accepting.
+    bool accepting(const std::vector<size_t>& pcs) const;
+
+private:
+    /// Get the state that has the threads at `pcs` after following epsilon transitions, adding
+    /// it to the cache if necessary. Returns `std::nullopt` if the cache is full.
+    std::optional<StateId> state_for(const std::vector<size_t>& pcs);
+    /// Follow the epsilon transitions from the threads at `pcs`, returning the program counters
+    /// of the instructions that wait for input and of `Match`, in ascending order.
+    std::vector<size_t> closure_of(const std::vector<size_t>& pcs);
+    std::optional<StateId> start_state();
+    std::optional<StateId> next_state(StateId from, size_t class_index);
+    /// Same as `state_for`, but clear the cache if it is full. Returns `std::nullopt` if the
+    /// cache is thrashing.
+    std::optional<StateId> state_or_clear(const std::vector<size_t>& pcs);
+    /// Make a transition, clearing the cache (but keeping `from`) if it is full. Returns
+    /// `std::nullopt` if the cache is thrashing.
+    std::optional<StateId> step(StateId from, size_t class_index);
+    /// Clear the cache. Returns false if the cache is thrashing and should not be rebuilt.
+    bool clear_cache();
+
+    std::reference_wrapper<const Regex> m_regex_ref;
+    bool m_searching;
+    Alphabet m_alphabet;
+    StateCache m_cache;
+    std::optional<StateId> m_start_state;
+    /// The number of characters processed since the cache has been cleared last time.
+    size_t m_chars_since_clear = 0;
+    pike_vm::SparseSet m_closure_set;
+    std::vector<size_t> m_closure_stack;
+    std::vector<size_t> m_start_pcs;
+    std::vector<size_t> m_all_pcs;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
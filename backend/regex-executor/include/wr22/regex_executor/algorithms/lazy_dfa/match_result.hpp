@@ -0,0 +1,10 @@
+#pragma once
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// The lazy DFA only answers whether a string matches: it never reports captures or steps.
+struct MatchResult {
+    bool matched;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
@@ -0,0 +1,64 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/executor.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/match_result.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// Matches a long string with the lazy DFA on several threads by splitting it into chunks.
+///
+/// The state the DFA enters a chunk in is only known once the previous chunks are done, so
+/// every chunk but the first is run from a speculated state on a DFA of its own. The chunks are
+/// shared between the calling thread and the threads of `utils::ThreadPool::shared()`. When
+/// searching, the speculated state is the start state: every state of a search contains its
+/// threads, so an accepting state reached from it is reached for real as well, and a match found
+/// in any chunk ends matching at once. When matching the whole string, the DFA is first run over
+/// the `warm_up_length` characters before the chunk from the state with every instruction,
+/// which usually narrows down to the state the DFA is actually in.
+///
+/// The runs are then composed from left to right. If the actual state at the start of a chunk
+/// differs from the speculated one, the chunk is run again from the actual state, but only
+/// until it reaches the same state as the speculative run at one of the checkpoints recorded
+/// every `checkpoint_interval` characters: from then on, both runs coincide.
+class ParallelExecutor {
+public:
+    static constexpr size_t default_min_chunk_length = 64 * 1024;
+    static constexpr size_t default_checkpoint_interval = 1024;
+    static constexpr size_t warm_up_length = 64;
+
+    explicit ParallelExecutor(
+        const Regex& regex_ref,
+        Fragment fragment = Fragment::Whole,
+        size_t min_chunk_length = default_min_chunk_length,
+        size_t checkpoint_interval = default_checkpoint_interval);
+
+    const Regex& regex_ref() const;
+    /// Match a string on up to `num_threads` threads (the number of hardware threads if 0),
+    /// returning `std::nullopt` if the state cache of some DFA thrashes. Strings shorter than
+    /// two chunks are matched on the calling thread only.
+    std::optional<MatchResult> execute(const std::u32string_view& string, size_t num_threads);
+
+private:
+    /// Get the DFA for the `index`-th chunk, creating it if necessary. Each chunk gets its own,
+    /// so that the DFAs keep their caches across `execute()` calls.
+    Executor& executor_at(size_t index);
+
+    std::reference_wrapper<const Regex> m_regex_ref;
+    Fragment m_fragment;
+    size_t m_min_chunk_length;
+    size_t m_checkpoint_interval;
+    std::vector<std::unique_ptr<Executor>> m_executors;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
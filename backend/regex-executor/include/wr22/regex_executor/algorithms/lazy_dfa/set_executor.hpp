@@ -0,0 +1,68 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/executor.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/set_match_result.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/state_cache.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/sparse_set.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/regex_set.hpp>
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// Matches strings against all the regexes of a `RegexSet` with a single lazily built DFA.
+///
+/// Works like `Executor`, except that the threads of a state may run any of the programs of
+/// the set: they are identified by the instruction numbers of `RegexSet`. A state is accepting
+/// if it has the `Match` instruction of some program, and it also knows which regexes these
+/// are. Matching thus takes one table lookup per character however many regexes there are,
+/// as long as the states stay few enough to fit in the cache.
+///
+/// When searching, the regexes found in every accepting state along the way are collected, and
+/// matching stops early once all of them have matched. `Fragment::All` is answered like
+/// `Fragment::Search`.
+class SetExecutor {
+public:
+    explicit SetExecutor(
+        const RegexSet& regex_set_ref,
+        Fragment fragment = Fragment::Whole,
+        size_t cache_capacity = Executor::default_cache_capacity);
+
+    const RegexSet& regex_set_ref() const;
+    /// Match a string, returning `std::nullopt` if the state cache thrashes.
+    std::optional<SetMatchResult> execute(const std::u32string_view& string);
+
+private:
+    /// Get the state that has the threads at the instruction numbers `pcs` after following
+    /// epsilon transitions, adding it to the cache if necessary. Returns `std::nullopt` if the
+    /// cache is full.
+    std::optional<StateId> state_for(const std::vector<size_t>& pcs);
+    /// Add a new state to the cache, recording the regexes it accepts.
+    StateId insert_state(std::vector<size_t> pcs);
+    std::optional<StateId> start_state();
+    std::optional<StateId> next_state(StateId from, size_t class_index);
+    /// Clear the cache. Returns false if the cache is thrashing and should not be rebuilt.
+    bool clear_cache();
+
+    std::reference_wrapper<const RegexSet> m_regex_set_ref;
+    bool m_searching;
+    StateCache m_cache;
+    /// The indices of the regexes each cached state accepts, in ascending order.
+    std::vector<std::vector<size_t>> m_state_matches;
+    std::optional<StateId> m_start_state;
+    /// The numbers of the first instructions of all the programs.
+    std::vector<size_t> m_start_pcs;
+    /// The number of characters processed since the cache has been cleared last time.
+    size_t m_chars_since_clear = 0;
+    pike_vm::SparseSet m_closure_set;
+    std::vector<size_t> m_closure_stack;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
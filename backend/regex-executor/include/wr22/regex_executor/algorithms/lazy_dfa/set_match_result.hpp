@@ -0,0 +1,15 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+/// The result of matching a string against a `RegexSet` with the combined lazy DFA.
+struct SetMatchResult {
+    /// The indices of the regexes that match the string, in ascending order.
+    std::vector<size_t> matched;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
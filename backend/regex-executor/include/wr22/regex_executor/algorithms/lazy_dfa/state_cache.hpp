@@ -0,0 +1,67 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+using StateId = uint32_t;
+
+/// The lazily built part of a DFA: its states and the transitions computed so far.
+///
+/// A DFA state is the set of program counters of the NFA threads alive at some input position
+/// (only the character-consuming and `Match` instructions are kept). The cache has a limited
+/// capacity in bytes: once it cannot fit a new state, the owner is expected to `clear()` it
+/// and start over.
+class StateCache {
+public:
+    /// The state without any threads. It never leads to a match and is never evicted.
+    static constexpr StateId dead_state = 0;
+    /// Marks the transitions that have not been computed yet.
+    static constexpr StateId unknown_state = std::numeric_limits<StateId>::max();
+
+    StateCache(size_t num_classes, size_t capacity);
+
+    /// Find the state with a given set of program counters (sorted in ascending order).
+    std::optional<StateId> find(const std::vector<size_t>& pcs) const;
+    /// Check whether a state with `num_pcs` program counters can be added without exceeding
+    /// the capacity.
+    bool can_fit(size_t num_pcs) const;
+    /// Add a new state. The caller must make sure it is not present yet and that it fits.
+    StateId insert(std::vector<size_t> pcs, bool accepting);
+
+    const std::vector<size_t>& pcs_of(StateId state) const;
+    bool accepting(StateId state) const;
+
+    StateId transition(StateId from, size_t class_index) const;
+    void set_transition(StateId from, size_t class_index, StateId to);
+
+    /// Remove all the states except for the dead one.
+    void clear();
+    size_t num_states() const;
+    size_t num_clears() const;
+
+private:
+    struct State {
+        std::vector<size_t> pcs;
+        bool accepting;
+    };
+
+    size_t state_size(size_t num_pcs) const;
+
+    size_t m_num_classes;
+    size_t m_capacity;
+    size_t m_memory_usage = 0;
+    size_t m_num_clears = 0;
+    std::vector<State> m_states;
+    std::map<std::vector<size_t>, StateId> m_ids;
+    /// `m_num_classes` entries per state.
+    std::vector<StateId> m_transitions;
+};
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
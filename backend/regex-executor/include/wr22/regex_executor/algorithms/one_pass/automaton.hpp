@@ -0,0 +1,76 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/alphabet.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::one_pass {
+
+using StateId = uint32_t;
+
+/// Assigns a Pike VM slot (see `pike_vm::SlotLayout`) either the current position or the value
+/// of another slot.
+struct SlotAction {
+    size_t slot;
+    /// The slot to copy the value from, or `std::nullopt` to store the current position.
+    std::optional<size_t> source_slot;
+};
+
+/// A DFA for a one-pass program, whose transitions also tell how to update the capture slots.
+///
+/// A program is one-pass if, wherever a thread can be, the next input character determines
+/// the path it takes: out of the consuming instructions reachable through epsilon transitions,
+/// no two consume the same character. A state of the automaton is then the location right
+/// after a consuming instruction (or the start of the program), and each transition carries
+/// the slot actions of the groups entered and left along its path. If an instruction can be
+/// reached through several paths, the one the backtracking algorithm tries first is taken,
+/// as in the Pike VM.
+///
+/// Programs with a repeated quantifier whose iteration can match the empty string are not
+/// considered one-pass, since the backtracking algorithm treats such iterations specially.
+class Automaton {
+public:
+    static constexpr StateId dead_state = std::numeric_limits<StateId>::max();
+    /// The limit on the number of transitions, above which building the automaton is not
+    /// worth it.
+    static constexpr size_t max_transitions = 1 << 16;
+
+    struct Transition {
+        /// The state to go to, or `dead_state` if the character cannot be consumed.
+        StateId to;
+        /// The range of `actions()` to run before consuming the character.
+        uint32_t actions_begin;
+        uint32_t actions_end;
+    };
+
+    /// Build the automaton for a program, or return `std::nullopt` if the program is not
+    /// one-pass or the automaton would be too large.
+    static std::optional<Automaton> build(const program::Program& program);
+
+    StateId start_state() const;
+    const Transition& transition(StateId from, char32_t c) const;
+    /// The transition to take to accept at the end of the input in a given state. Its `to` is
+    /// `dead_state` if the state is not accepting.
+    const Transition& accept_transition(StateId state) const;
+    std::span<const SlotAction> actions(const Transition& transition) const;
+
+private:
+    explicit Automaton(const program::Program& program);
+
+    lazy_dfa::Alphabet m_alphabet;
+    /// `num_classes` entries per state.
+    std::vector<Transition> m_transitions;
+    /// One entry per state.
+    std::vector<Transition> m_accept_transitions;
+    std::vector<SlotAction> m_actions;
+};
+
+}  // namespace wr22::regex_executor::algorithms::one_pass
@@ -0,0 +1,36 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/one_pass/match_result.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/slot_layout.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::one_pass {
+
+/// Matches whole strings against one-pass regexes (see `Automaton`), filling the capture slots
+/// in a single left-to-right scan, without backtracking and without thread lists.
+///
+/// The captures agree with those of the backtracking algorithm. The slots are kept between
+/// `execute()` calls, so an executor must not be used from several threads at once.
+class Executor {
+public:
+    explicit Executor(const Regex& regex_ref);
+
+    const Regex& regex_ref() const;
+    /// Match the whole string, returning `std::nullopt` if the regex is not one-pass.
+    std::optional<MatchResult> execute(const std::u32string_view& string);
+
+private:
+    std::reference_wrapper<const Regex> m_regex_ref;
+    pike_vm::SlotLayout m_slot_layout;
+    std::vector<size_t> m_slots;
+};
+
+}  // namespace wr22::regex_executor::algorithms::one_pass
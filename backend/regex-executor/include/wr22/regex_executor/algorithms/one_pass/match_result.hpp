@@ -0,0 +1,16 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/capture.hpp>
+
+// stl
+#include <optional>
+
+namespace wr22::regex_executor::algorithms::one_pass {
+
+struct MatchResult {
+    bool matched;
+    std::optional<Captures> captures;
+};
+
+}  // namespace wr22::regex_executor::algorithms::one_pass
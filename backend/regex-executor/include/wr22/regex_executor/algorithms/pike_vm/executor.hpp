@@ -0,0 +1,45 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/match_result.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/match_scratch.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/slot_layout.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <functional>
+#include <string_view>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+/// Matches strings by simulating the regex program as an NFA (Pike VM).
+///
+/// All the possible threads of execution are advanced in lockstep, one input character at
+/// a time, with at most one thread per program instruction. Hence matching takes `O(n·m)`
+/// time and `O(m)` memory regardless of the regex, where `n` is the length of the string and
+/// `m` is the size of the program. The bookkeeping instructions (groups, alternatives,
+/// quantifiers) are treated as epsilon transitions. Threads are kept in the order of priority
+/// the backtracking algorithm would try them in, so the captures agree with it, unless an
+/// iteration of a quantifier can match the empty string. When searching,
+/// a thread that starts matching at the current position is added with the lowest priority
+/// until a match is found, so the whole search is still a single pass over the string.
+///
+/// The thread lists are allocated once and reused by every `execute()` call (see
+/// `MatchScratch`), so an executor must not be used from several threads at once.
+class Executor {
+public:
+    explicit Executor(const Regex& regex_ref);
+
+    const Regex& regex_ref() const;
+    MatchResult execute(
+        const std::u32string_view& string,
+        Fragment fragment = Fragment::Whole);
+
+private:
+    std::reference_wrapper<const Regex> m_regex_ref;
+    SlotLayout m_slot_layout;
+    MatchScratch m_scratch;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
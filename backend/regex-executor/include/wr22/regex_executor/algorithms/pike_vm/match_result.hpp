@@ -0,0 +1,20 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/capture.hpp>
+
+// stl
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+struct MatchResult {
+    bool matched;
+    std::optional<Captures> captures;
+    /// The captures of every match, if all the matches have been requested with
+    /// `Fragment::All`. `captures` then holds the first of them.
+    std::optional<std::vector<Captures>> matches;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
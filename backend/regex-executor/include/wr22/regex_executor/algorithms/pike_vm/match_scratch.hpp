@@ -0,0 +1,43 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/thread_list.hpp>
+#include <wr22/utils/adt.hpp>
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+/// Frames of the stack the epsilon transitions are followed with.
+namespace frame {
+    /// Follow the epsilon transitions starting at `pc`.
+    struct Explore {
+        size_t pc;
+    };
+
+    /// Restore the value of a slot once the exploration of a branch is over.
+    struct RestoreSlot {
+        size_t slot;
+        size_t value;
+    };
+}  // namespace frame
+
+using Frame = wr22::utils::Adt<frame::Explore, frame::RestoreSlot>;
+
+/// The buffers the Pike VM works in.
+///
+/// Their sizes only depend on the program, so they are allocated once per executor and reused
+/// by every run. Their contents mean nothing outside of a run.
+struct MatchScratch {
+    MatchScratch(size_t num_instructions, size_t num_slots);
+
+    ThreadList current;
+    ThreadList next;
+    /// The slots of the thread being added.
+    std::vector<size_t> slots;
+    std::vector<Frame> stack;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
@@ -0,0 +1,50 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/capture.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+/// The value of a slot that has not been set.
+constexpr size_t unset_slot = program::unset_capture_position;
+
+/// Describes how the capture positions of a Pike VM thread are laid out in its slots.
+///
+/// The first slots hold the beginning and the end of the capture recorded in each capture slot
+/// of the program, laid out as `program::make_captures` expects them. They are followed by one
+/// slot per capturing group, holding the position where the group has been entered most
+/// recently, and by two slots holding the beginning and the end of the whole match.
+class SlotLayout {
+public:
+    explicit SlotLayout(const program::Program& program);
+
+    size_t num_slots() const;
+
+    /// Get the index of the capturing group that uses a given group position register, or
+    /// `std::nullopt` if the group it belongs to does not capture.
+    std::optional<size_t> group_of_register(size_t position_register) const;
+
+    static size_t begin_slot(size_t capture_slot);
+    static size_t end_slot(size_t capture_slot);
+    size_t entry_slot(size_t group) const;
+    size_t match_begin_slot() const;
+    size_t match_end_slot() const;
+
+    /// Build `Captures` out of the slots of a matching thread.
+    Captures make_captures(std::span<const size_t> slots) const;
+
+private:
+    std::reference_wrapper<const program::Program> m_program;
+    std::vector<std::optional<size_t>> m_group_of_register;
+    size_t m_num_groups = 0;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
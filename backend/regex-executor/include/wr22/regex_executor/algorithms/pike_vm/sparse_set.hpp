@@ -0,0 +1,34 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+/// A set of integers from `0..capacity` with `O(1)` insertion, lookup and clearing.
+///
+/// Elements are kept in the order of insertion, which the Pike VM relies upon to preserve the
+/// priority of its threads. See https://research.swtch.com/sparse for the details of this data
+/// structure.
+class SparseSet {
+public:
+    explicit SparseSet(size_t capacity);
+
+    /// Insert `value` into the set. Returns false if it is already present.
+    bool insert(size_t value);
+    bool contains(size_t value) const;
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    /// Get the `index`-th element in the order of insertion.
+    size_t at(size_t index) const;
+
+private:
+    std::vector<size_t> m_dense;
+    std::vector<size_t> m_sparse;
+    size_t m_size = 0;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
@@ -0,0 +1,41 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/sparse_set.hpp>
+
+// stl
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+/// The list of Pike VM threads alive at a given input position.
+///
+/// A thread is identified by its program counter, and no two threads share one, since a
+/// thread that reaches a program counter already taken by a higher-priority thread cannot
+/// lead to a better match. The capture slots of the thread at `pc` are stored in a flat
+/// array at `slots_at(pc)`.
+class ThreadList {
+public:
+    ThreadList(size_t num_instructions, size_t num_slots);
+
+    /// Add a thread at `pc`. Returns false if there already is one.
+    bool insert(size_t pc);
+    void clear();
+
+    size_t size() const;
+    bool empty() const;
+    /// Get the program counter of the `index`-th thread in the order of priority.
+    size_t pc_at(size_t index) const;
+
+    std::span<size_t> slots_at(size_t pc);
+    std::span<const size_t> slots_at(size_t pc) const;
+
+private:
+    SparseSet m_pcs;
+    size_t m_num_slots;
+    std::vector<size_t> m_slots;
+};
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
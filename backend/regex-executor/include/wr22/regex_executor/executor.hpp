@@ -1,29 +1,89 @@
 #pragma once
 
 // wr22
-#include "wr22/regex_executor/algorithms/backtracking/match_result.hpp"
-#include <string_view>
-#include <wr22/regex_executor/regex.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/executor.hpp>
+#include <wr22/regex_executor/algorithms/bit_parallel/executor.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/executor.hpp>
+#include <wr22/regex_executor/algorithms/lazy_dfa/parallel_executor.hpp>
+#include <wr22/regex_executor/algorithms/one_pass/executor.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/executor.hpp>
+#include <wr22/regex_executor/match_options.hpp>
+#include <wr22/regex_executor/match_result.hpp>
+#include <wr22/regex_executor/planner.hpp>
+#include <wr22/regex_executor/regex.hpp>
 
 // stl
-#include <functional>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
 
 namespace wr22::regex_executor {
 
 class Executor {
 public:
-    using BacktrackingResult = algorithms::backtracking::MatchResult;
+    /// The total length of the strings of a batch starting from which they are matched on
+    /// several threads. Handing shorter batches over to other threads costs more than matching
+    /// them on the calling one.
+    static constexpr size_t min_parallel_batch_length = 1 << 16;
 
     explicit Executor(const Regex& regex_ref);
 
     const Regex& regex_ref() const;
-    BacktrackingResult execute(const std::u32string_view& string);
+    const Planner& planner() const;
+    /// Match a string with the algorithm selected by `MatchOptions::algorithm`, or by the
+    /// planner if it is not set.
+    MatchResult execute(const std::u32string_view& string, const MatchOptions& options = {});
+    /// Match a string with the backtracking algorithm, passing the steps to `step_sink` as soon
+    /// as they are made. `MatchOptions::algorithm` and `MatchOptions::record_steps` are ignored.
+    MatchResult execute(
+        const std::u32string_view& string,
+        const MatchOptions& options,
+        algorithms::backtracking::StepSink& step_sink);
+    /// Find all the non-overlapping matches in a string (see `Fragment::All`), ignoring
+    /// `MatchOptions::fragment`. The matches are listed in `MatchResult::matches`.
+    MatchResult find_all(const std::u32string_view& string, const MatchOptions& options = {});
+    /// Match many strings with the same options on up to `num_threads` threads (the number of
+    /// hardware threads if 0), returning the results in the order of the strings. Batches
+    /// shorter than `min_parallel_batch_length` in total are matched on the calling thread.
+    ///
+    /// The calling thread matches strings with this executor, and the threads of
+    /// `utils::ThreadPool::shared()` help it with executors of their own for the same regex,
+    /// since the scratch space of an executor cannot be shared. These executors are kept for
+    /// the next batches. The threads take the next string as soon as they are done with the
+    /// previous one, so a few slow strings do not hold up the rest. If matching a string throws,
+    /// e.g. `BudgetExceeded`, no more strings are started and the exception is rethrown.
+    std::vector<MatchResult> execute_batch(
+        std::span<const std::u32string_view> strings,
+        const MatchOptions& options = {},
+        size_t num_threads = 0);
+    /// Same as above, but with the options for each string given separately. `options` must be
+    /// as long as `strings`.
+    std::vector<MatchResult> execute_batch(
+        std::span<const std::u32string_view> strings,
+        std::span<const MatchOptions> options,
+        size_t num_threads = 0);
 
 private:
-    using BacktrackingExecutor = algorithms::backtracking::Executor;
+    /// The algorithm that is run when `algorithm` is asked for to match `fragment`: the one-pass
+    /// DFA, the bit-parallel algorithm and the lazy DFA are replaced by the next best one when
+    /// they cannot handle the regex or the fragment. The lazy DFA may still fall back to the Pike
+    /// VM while matching, if its state cache thrashes.
+    Algorithm runnable_algorithm(Algorithm algorithm, Fragment fragment) const;
 
-    BacktrackingExecutor m_executor;
+    algorithms::backtracking::Executor m_backtracking_executor;
+    algorithms::pike_vm::Executor m_pike_vm_executor;
+    algorithms::lazy_dfa::Executor m_lazy_dfa_executor;
+    algorithms::lazy_dfa::Executor m_lazy_dfa_search_executor;
+    algorithms::lazy_dfa::ParallelExecutor m_parallel_lazy_dfa_executor;
+    algorithms::lazy_dfa::ParallelExecutor m_parallel_lazy_dfa_search_executor;
+    algorithms::one_pass::Executor m_one_pass_executor;
+    algorithms::bit_parallel::Executor m_bit_parallel_executor;
+    Planner m_planner;
+    /// The executors of the threads that help match batches, created on first use.
+    std::vector<std::unique_ptr<Executor>> m_batch_executors;
 };
 
-}
+}  // namespace wr22::regex_executor
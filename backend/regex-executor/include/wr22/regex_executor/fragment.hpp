@@ -0,0 +1,28 @@
+#pragma once
+
+// stl
+#include <optional>
+#include <string_view>
+
+namespace wr22::regex_executor {
+
+/// Which portion of a string has to be matched by a regular expression.
+enum class Fragment {
+    /// The regex must match the entire string.
+    Whole,
+    /// The regex may match any substring. The leftmost match is reported; among the matches
+    /// starting at the same position, the one preferred by the backtracking algorithm wins.
+    Search,
+    /// Find all the non-overlapping matches, from left to right. Each search resumes where the
+    /// previous match has ended; after an empty match, it resumes one character later.
+    All,
+};
+
+/// Get the name of a fragment kind as used in the `/match` interface.
+const char* fragment_name(Fragment fragment);
+
+/// Get a fragment kind by its name (see `fragment_name`), or `std::nullopt` if there is no
+/// fragment kind with this name.
+std::optional<Fragment> fragment_from_name(std::string_view name);
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,66 @@
+#pragma once
+
+// stl
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+
+namespace wr22::regex_executor {
+
+/// Limits on the resources that matching a string may use. Absent limits are not enforced.
+///
+/// Only the backtracking algorithm, whose running time is not bounded otherwise, checks the
+/// budget. The checks are amortized: they are made once every `check_interval` instructions,
+/// so a limit may be exceeded by the amount of work done in between before matching stops.
+struct MatchBudget {
+    /// The number of instructions between two consecutive checks.
+    static constexpr size_t check_interval = 1024;
+
+    /// The maximum number of program instructions to execute. Each executed instruction
+    /// records at most one step.
+    std::optional<size_t> max_steps;
+    /// The maximum number of decisions (alternatives or quantifier repetitions) to make.
+    std::optional<size_t> max_decisions;
+    /// The maximum number of bytes of memory used by the backtracking state, the memoization
+    /// table and the recorded steps, approximately.
+    std::optional<size_t> max_memory;
+    /// The point in time by which matching has to be finished.
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+};
+
+/// How much work has been done while matching a string.
+struct MatchStatistics {
+    /// The number of program instructions executed.
+    size_t steps = 0;
+    /// The number of decisions made.
+    size_t decisions = 0;
+    /// The peak memory usage in bytes, as estimated when the budget was last checked.
+    size_t memory = 0;
+    /// The furthest string position reached.
+    size_t max_string_pos = 0;
+};
+
+/// The exception thrown when matching a string exceeds its `MatchBudget`.
+class BudgetExceeded : public std::runtime_error {
+public:
+    /// The limit that has been exceeded.
+    enum class Reason {
+        Steps,
+        Decisions,
+        Memory,
+        Deadline,
+    };
+
+    BudgetExceeded(Reason reason, MatchStatistics statistics);
+
+    Reason reason() const;
+    /// The work done before matching has been stopped.
+    const MatchStatistics& statistics() const;
+
+private:
+    Reason m_reason;
+    MatchStatistics m_statistics;
+};
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,63 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithm.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/match_budget.hpp>
+
+// stl
+#include <cstddef>
+#include <optional>
+
+namespace wr22::regex_executor {
+
+/// Options that control how a string is matched against a regular expression.
+struct MatchOptions {
+    /// Whether the steps of the matching process should be recorded.
+    ///
+    /// If false, no steps are constructed at all, and `MatchResult::steps` is left empty. This is
+    /// considerably faster when only the verdict and the captures are of interest: besides, the
+    /// backtracking algorithm then does not remember the options it would be pointless to come
+    /// back to, such as giving back a repetition of `[0-9]+` in `[0-9]+,` when the next
+    /// character is a digit. Only `Algorithm::Backtracking` records steps; other algorithms
+    /// ignore this option.
+    bool record_steps = true;
+
+    /// Whether the backtracking algorithm should remember the states it has already explored.
+    ///
+    /// If true, the backtracking algorithm records every (decision point, string position) pair
+    /// from which everything it has explored has failed, and gives up on a path as soon as it
+    /// reaches a recorded pair again. Only the paths that cannot lead to a match are pruned, so
+    /// the match and its captures are the same as without memoization. This bounds the matching
+    /// time by `O(n·m)`, where `n` is the length of the string and `m` is the size of the regex
+    /// program, at the cost of `O(n·m)` bits of memory. Failures at the very beginning of a
+    /// repetition of a quantifier are not recorded, since they may be caused by the repetition
+    /// being empty. The steps are recorded the same way as without memoization, but the pruned
+    /// paths are not explored and thus produce no steps.
+    bool memoize = false;
+
+    /// Whether the captures are needed.
+    ///
+    /// If false, the planner may choose an algorithm that only tells whether the string
+    /// matches. The captures are still reported if the chosen algorithm finds them anyway.
+    bool record_captures = true;
+
+    /// Which portion of the string has to be matched.
+    Fragment fragment = Fragment::Whole;
+
+    /// The algorithm to match the string with, or `std::nullopt` to let `Planner` choose the
+    /// fastest one that gives what the other options ask for. The steps are only recorded by
+    /// `Algorithm::Backtracking`, so it is always chosen if `record_steps` is true.
+    std::optional<Algorithm> algorithm;
+
+    /// Limits on the work done while matching. If one of them is exceeded, `BudgetExceeded` is
+    /// thrown.
+    MatchBudget budget = {};
+
+    /// The number of threads a single string may be matched on, or 0 for the number of
+    /// hardware threads. Only `Algorithm::LazyDfa` uses more than one: it splits long strings
+    /// into chunks and runs them at the same time (see `algorithms::lazy_dfa::ParallelExecutor`).
+    size_t max_threads = 1;
+};
+
+}  // namespace wr22::regex_executor
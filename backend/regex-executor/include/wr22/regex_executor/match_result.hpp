@@ -0,0 +1,36 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithm.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+#include <wr22/regex_executor/capture.hpp>
+
+// stl
+#include <optional>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json_fwd.hpp>
+
+namespace wr22::regex_executor {
+
+/// The result of matching a string with any of the algorithms.
+struct MatchResult {
+    /// The algorithm that has been used.
+    Algorithm algorithm;
+    bool matched;
+    /// The captures made. Only present if `matched` is true and the algorithm reports captures
+    /// (`Algorithm::LazyDfa` and `Algorithm::BitParallel` do not).
+    std::optional<Captures> captures;
+    /// The captures of every match, if all the matches have been requested with
+    /// `Fragment::All`. `captures` then holds the first of them. Only present for the
+    /// algorithms that report captures.
+    std::optional<std::vector<Captures>> matches;
+    /// The steps made during matching. `std::nullopt` if the algorithm does not record steps or
+    /// recording them was disabled by `MatchOptions::record_steps`.
+    std::optional<std::vector<algorithms::backtracking::Step>> steps;
+};
+
+void to_json(nlohmann::json& j, const MatchResult& result);
+
+}  // namespace wr22::regex_executor
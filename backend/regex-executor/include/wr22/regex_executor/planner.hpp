@@ -0,0 +1,81 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/match_options.hpp>
+#include <wr22/regex_executor/regex.hpp>
+
+// stl
+#include <cstddef>
+
+namespace wr22::regex_executor {
+
+/// What the planner knows about a compiled regex.
+struct RegexProfile {
+    /// The number of capture slots of the program.
+    size_t num_capture_slots = 0;
+    /// The number of instructions of the program.
+    size_t num_instructions = 0;
+    /// Whether the regex is one-pass (see `Regex::one_pass_automaton`).
+    bool one_pass = false;
+    /// Whether the regex is short enough for the bit-parallel algorithm (see
+    /// `Regex::bit_parallel_automaton`).
+    bool bit_parallel = false;
+    /// Whether the regex matches a single literal string (see `Prefilter::exact`).
+    bool literal = false;
+    /// Whether an iteration of an unbounded quantifier can match the empty string (see
+    /// `program::has_empty_unbounded_iteration`). Only the backtracking algorithm is then
+    /// guaranteed to report the captures it defines.
+    bool empty_iterations = false;
+    /// Whether the backtracking algorithm may take super-linear time on some strings: an
+    /// unbounded quantifier contains another one or alternatives that overlap, or two unbounded
+    /// quantifiers that overlap can follow each other.
+    bool backtracking_risk = false;
+
+    /// Inspect a compiled regex.
+    static RegexProfile of(const Regex& regex);
+};
+
+/// Picks the algorithm to match a string with when `MatchOptions::algorithm` is not set.
+///
+/// The choice is the fastest algorithm that gives what has been asked for, exactly as the
+/// backtracking algorithm would:
+///
+/// 1. The steps are only recorded by the backtracking algorithm, and memoization only tunes it.
+/// 2. If only the verdict is needed, the bit-parallel algorithm is used for short regexes and
+///    the lazy DFA for the others, as well as for long strings that may be split between
+///    threads.
+/// 3. The one-pass DFA finds the captures of one-pass regexes in the whole string.
+/// 4. Regexes with a backtracking risk are matched by memoized backtracking if the memoization
+///    table is small and they either have empty iterations or many captures; otherwise they
+///    are matched by the Pike VM, whose captures of empty iterations may differ (see
+///    `Algorithm::PikeVm`). Plain backtracking may take exponential time on them.
+/// 5. Literal regexes and the other regexes with empty iterations are matched by backtracking:
+///    the former are found by the start filter, and the captures of the latter are only defined
+///    by it.
+/// 6. Long strings are searched with the Pike VM, since searching with backtracking may take
+///    quadratic time; everything else is matched by backtracking, which is the fastest for
+///    short strings.
+class Planner {
+public:
+    /// The length of a string starting from which searching with backtracking is avoided.
+    static constexpr size_t long_string = 4096;
+    /// The number of capture slots starting from which memoized backtracking is preferred to
+    /// the Pike VM, which copies the slots between its threads.
+    static constexpr size_t many_capture_slots = 4;
+    /// The maximum number of bits in the memoization table for memoized backtracking to be
+    /// chosen.
+    static constexpr size_t max_memoization_bits = 1 << 23;
+
+    explicit Planner(const Regex& regex_ref);
+
+    const RegexProfile& profile() const;
+    /// Fill in `MatchOptions::algorithm` (and `MatchOptions::memoize`, if memoized backtracking
+    /// is chosen) for matching a string of length `string_length`. The options are returned
+    /// unchanged if the algorithm is already set.
+    MatchOptions plan(const MatchOptions& options, size_t string_length) const;
+
+private:
+    RegexProfile m_profile;
+};
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,44 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_parser/regex/part.hpp>
+
+// stl
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace wr22::regex_executor {
+
+/// Literal strings that every match of a regex must contain, extracted from its parse tree.
+///
+/// They allow rejecting a string without running any matching algorithm: a string that does
+/// not contain the required literals cannot match. The extraction is conservative: if nothing
+/// can be said about a part of the regex, the corresponding literal is left empty.
+class Prefilter {
+public:
+    explicit Prefilter(const regex_parser::regex::SpannedPart& root_part);
+
+    /// The literal every match starts with.
+    const std::u32string& prefix() const;
+    /// The literal every match ends with.
+    const std::u32string& suffix() const;
+    /// The longest literal found that every match contains (at least as long as `prefix()`
+    /// and `suffix()`).
+    const std::u32string& required() const;
+    /// The only string the regex matches, if it matches exactly one (e.g. `foo` or `f(o)o`).
+    const std::optional<std::u32string>& exact() const;
+
+    /// Check whether `string` may contain a match of the given kind. If this returns false,
+    /// there is certainly no match.
+    bool may_match(std::u32string_view string, Fragment fragment) const;
+
+private:
+    std::u32string m_prefix;
+    std::u32string m_suffix;
+    std::u32string m_required;
+    std::optional<std::u32string> m_exact;
+};
+
+}  // namespace wr22::regex_executor
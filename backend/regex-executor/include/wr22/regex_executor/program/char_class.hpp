@@ -0,0 +1,45 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_parser/regex/character_class_data.hpp>
+
+// stl
+#include <bitset>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+/// A character class compiled for fast membership tests.
+///
+/// The ranges of the class are sorted and merged, and the inversion is folded in, so that the
+/// class is described by a sorted list of disjoint, non-adjacent ranges of the characters it
+/// matches. ASCII characters are looked up in a bitmap, and the other ones are binary-searched
+/// in the ranges.
+class CompiledCharClass {
+public:
+    /// An inclusive range of characters.
+    struct Range {
+        char32_t first;
+        char32_t last;
+        bool operator==(const Range& other) const = default;
+    };
+
+    explicit CompiledCharClass(const regex_parser::regex::CharacterClassData& data);
+    /// Build a class matching the characters of the given ranges, in any order.
+    explicit CompiledCharClass(std::vector<Range> ranges);
+
+    /// Check whether the class matches a given character.
+    bool matches(char32_t c) const;
+
+    /// The ranges of the characters the class matches, sorted and disjoint.
+    const std::vector<Range>& ranges() const;
+
+private:
+    /// Fill in `m_ascii` from `m_ranges`.
+    void fill_ascii();
+
+    std::vector<Range> m_ranges;
+    std::bitset<128> m_ascii;
+};
+
+}  // namespace wr22::regex_executor::program
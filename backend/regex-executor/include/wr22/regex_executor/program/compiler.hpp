@@ -0,0 +1,14 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/program/program.hpp>
+#include <wr22/regex_parser/regex/part.hpp>
+
+namespace wr22::regex_executor::program {
+
+/// Compile a regex into a `Program`.
+///
+/// Indexed capture groups are numbered from 1 in the order of their opening parentheses.
+Program compile(const regex_parser::regex::SpannedPart& root_part);
+
+}  // namespace wr22::regex_executor::program
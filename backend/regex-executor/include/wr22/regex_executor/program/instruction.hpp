@@ -0,0 +1,171 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/quantifier_type.hpp>
+#include <wr22/utils/adt.hpp>
+
+// stl
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+/// Instructions of a compiled regex program.
+///
+/// A program is a flat list of instructions addressed by their indices (program counters).
+/// Unless stated otherwise, an instruction continues with the next one (`pc + 1`) after
+/// being executed successfully. Some instructions store indices of registers: these are
+/// per-execution scratch variables used to keep track of positions and repetition counts.
+/// Engines that do not produce a drilldown of the matching process are free to treat the
+/// bookkeeping instructions (groups, quantifiers, alternatives) as no-ops, except that they
+/// must follow their jump targets.
+namespace instruction {
+    /// A run of consecutive `Literal` instructions, as a string in `Program::literal_runs`.
+    struct LiteralRun {
+        size_t string_index;
+        /// The position in the string of the literal this run is referred to from.
+        size_t offset;
+        bool operator==(const LiteralRun& other) const = default;
+    };
+
+    /// Match a single character literally.
+    struct Literal {
+        char32_t character;
+        /// If this literal is followed by more `Literal` instructions, the characters of all of
+        /// them, starting with this one: `Program::literal_runs[run.string_index]` from
+        /// `run.offset` on. Lets them be compared with the string at once.
+        std::optional<LiteralRun> run;
+        bool operator==(const Literal& other) const = default;
+    };
+
+    /// Match any single character.
+    struct Wildcard {
+        bool operator==(const Wildcard& other) const = default;
+    };
+
+    /// Match a single character against a character class from `Program::char_classes`.
+    struct CharClass {
+        size_t class_index;
+        bool operator==(const CharClass& other) const = default;
+    };
+
+    /// Choose one of the alternatives, starting at `targets`, in order of preference.
+    ///
+    /// The input position at which the choice is made is stored in `position_register`.
+    struct Alternatives {
+        size_t position_register;
+        std::vector<size_t> targets;
+        bool operator==(const Alternatives& other) const = default;
+    };
+
+    /// Finish matching the alternative `alternative_index` of the `Alternatives` instruction
+    /// located at `alternatives_pc` and continue execution at `target`.
+    struct FinishAlternative {
+        size_t alternatives_pc;
+        size_t alternative_index;
+        size_t target;
+        bool operator==(const FinishAlternative& other) const = default;
+    };
+
+    /// Begin a group, storing the current input position in `position_register`.
+    struct BeginGroup {
+        size_t position_register;
+        bool operator==(const BeginGroup& other) const = default;
+    };
+
+    /// End the group that has been begun with the `BeginGroup` instruction using the same
+    /// `position_register` and record its capture, if any.
+    struct EndGroup {
+        size_t position_register;
+        /// The capture slot (see `Program::capture_slots`) to record the capture in, if the
+        /// group captures.
+        std::optional<size_t> capture_slot;
+        bool operator==(const EndGroup& other) const = default;
+    };
+
+    /// Begin a quantifier: reset the repetition counter in `counter_register` and store the
+    /// current input position in `position_register` and `iteration_register`.
+    struct BeginQuantifier {
+        QuantifierType type;
+        size_t counter_register;
+        size_t position_register;
+        size_t iteration_register;
+        bool operator==(const BeginQuantifier& other) const = default;
+    };
+
+    /// What a program can do right after a quantifier stops repeating, before consuming any
+    /// other character.
+    struct ExitFollow {
+        /// The class in `Program::char_classes` of the characters the program can consume first.
+        size_t class_index;
+        /// Whether the `Match` instruction can be reached without consuming a character.
+        bool may_match;
+        bool operator==(const ExitFollow& other) const = default;
+    };
+
+    /// Decide whether to match one more repetition of a quantified item (starting at `body`)
+    /// or to stop repeating (continuing at `exit`). Repeating is preferred.
+    ///
+    /// `quantifier_pc` points to the corresponding `BeginQuantifier` instruction. The bounds on
+    /// the number of repetitions are encoded by the layout of the program, so this instruction
+    /// does not need to check them.
+    ///
+    /// If stopping at the current position cannot lead to a match because the next character
+    /// is not in `exit_follow`, the engines may drop the option to stop here. Giving back
+    /// repetitions of `[0-9]+` in `[0-9]+,` never helps, for example, so the quantifier can
+    /// behave as if it were possessive.
+    struct QuantifierSplit {
+        size_t quantifier_pc;
+        size_t body;
+        size_t exit;
+        /// What can follow the quantifier, or `std::nullopt` if any character can.
+        std::optional<ExitFollow> exit_follow;
+        /// Whether the body is a single instruction that consumes one character (a literal, a
+        /// wildcard or a character class) followed by `EndIteration`, so that the repetitions
+        /// can be matched as a run of characters (of at most one character for `Optional`).
+        bool single_char_body = false;
+        bool operator==(const QuantifierSplit& other) const = default;
+    };
+
+    /// Finish one repetition of a quantified item and continue at `target`.
+    ///
+    /// For unbounded quantifiers, a repetition that has consumed no input after the minimum
+    /// number of repetitions has been reached fails, which prevents infinite loops.
+    struct EndIteration {
+        size_t quantifier_pc;
+        size_t target;
+        bool operator==(const EndIteration& other) const = default;
+    };
+
+    /// Finish matching a quantifier that has been begun at `quantifier_pc`.
+    struct EndQuantifier {
+        size_t quantifier_pc;
+        bool operator==(const EndQuantifier& other) const = default;
+    };
+
+    /// Report a successful match.
+    struct Match {
+        bool operator==(const Match& other) const = default;
+    };
+
+    using Adt = wr22::utils::Adt<
+        Literal,
+        Wildcard,
+        CharClass,
+        Alternatives,
+        FinishAlternative,
+        BeginGroup,
+        EndGroup,
+        BeginQuantifier,
+        QuantifierSplit,
+        EndIteration,
+        EndQuantifier,
+        Match>;
+}  // namespace instruction
+
+struct Instruction : public instruction::Adt {
+    using instruction::Adt::Adt;
+};
+
+}  // namespace wr22::regex_executor::program
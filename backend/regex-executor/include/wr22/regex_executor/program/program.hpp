@@ -0,0 +1,78 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/capture.hpp>
+#include <wr22/regex_executor/program/char_class.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_parser/span/span.hpp>
+
+// stl
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+/// What a capture slot of a program records the captures of.
+struct CaptureSlot {
+    /// The index of the group, if the slot belongs to a group captured by index.
+    std::optional<size_t> index;
+    /// The name of the groups, if the slot belongs to groups captured by name.
+    std::optional<std::string> name;
+};
+
+/// A regex compiled into a flat list of instructions.
+///
+/// Execution starts at the instruction with index 0 and succeeds when the `Match` instruction
+/// is reached at the end of the input string (or at any position, when searching for a match
+/// in a string, see `Fragment::Search`). See `instruction` for the description of the
+/// instructions.
+struct Program {
+    /// The instructions of the program.
+    std::vector<Instruction> instructions;
+    /// The span of the regex part each instruction has been compiled from (same length as
+    /// `instructions`).
+    std::vector<regex_parser::span::Span> spans;
+    /// The character classes referenced by `instruction::CharClass`.
+    std::vector<CompiledCharClass> char_classes;
+    /// The runs of consecutive literals referenced by `instruction::Literal::run`.
+    std::vector<std::u32string> literal_runs;
+    /// The number of registers used by the program.
+    size_t num_registers = 0;
+    /// The number of groups captured by index. The indices are `1..=num_indexed_captures`.
+    size_t num_indexed_captures = 0;
+    /// The capture slots used by `instruction::EndGroup`, each holding the latest capture of a
+    /// group. All the groups with the same name share a slot, since only the latest of their
+    /// captures is reported.
+    std::vector<CaptureSlot> capture_slots;
+};
+
+/// The value of a capture position that has not been set.
+constexpr size_t unset_capture_position = std::numeric_limits<size_t>::max();
+
+/// Build `Captures` out of the positions recorded in the capture slots of `program`: the
+/// beginning and the end of the capture for each slot, in this order, or
+/// `unset_capture_position` for the slots that have not been set.
+Captures make_captures(
+    const Program& program,
+    Capture whole,
+    std::span<const size_t> capture_positions);
+
+/// Check whether the instruction at `pc` consumes the character `c`, that is, whether it is
+/// a `Literal`, `Wildcard` or `CharClass` instruction that matches `c`.
+bool consumes(const Program& program, size_t pc, char32_t c);
+
+/// Get the instructions reachable from the one at `pc` through a single epsilon transition, in
+/// the order of priority. Consuming instructions and `Match` have none.
+std::vector<size_t> epsilon_successors(const Program& program, size_t pc);
+
+/// Check whether an iteration of an unbounded quantifier can match the empty string, that is,
+/// whether its `EndIteration` can be reached from the start of its body without consuming a
+/// character. The backtracking algorithm treats such iterations specially, so the engines that
+/// simulate all the paths at once may report different captures for them.
+bool has_empty_unbounded_iteration(const Program& program);
+
+}  // namespace wr22::regex_executor::program
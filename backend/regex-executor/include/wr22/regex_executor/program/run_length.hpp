@@ -0,0 +1,46 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/program/char_class.hpp>
+
+// stl
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+namespace wr22::regex_executor::program {
+
+/// The instruction sets that the run length functions can compare characters with.
+enum class SimdLevel {
+    /// One character at a time.
+    Scalar,
+    /// 4 characters at a time.
+    Sse2,
+    /// 8 characters at a time.
+    Avx2,
+};
+
+/// The best instruction set supported both by the build and by the CPU. It is detected on the
+/// first call.
+SimdLevel supported_simd_level();
+
+/// Count the characters at the beginning of `string` that lie in one of `ranges`, comparing
+/// them with the instruction set `level`, which must be supported.
+size_t ranges_run_length(
+    std::u32string_view string,
+    std::span<const CompiledCharClass::Range> ranges,
+    SimdLevel level = supported_simd_level());
+
+/// Count the characters at the beginning of `string` that are equal to `c`.
+size_t literal_run_length(std::u32string_view string, char32_t c);
+
+/// Find the first occurrence of `literal` in `string` at or after `from`, like
+/// `std::u32string_view::find`, but skip the characters other than the first one of `literal`
+/// with the vector instructions of `ranges_run_length`.
+size_t find_literal(std::u32string_view string, std::u32string_view literal, size_t from = 0);
+
+/// Count the characters at the beginning of `string` that `char_class` matches. Classes with
+/// many ranges are looked up one character at a time.
+size_t class_run_length(std::u32string_view string, const CompiledCharClass& char_class);
+
+}  // namespace wr22::regex_executor::program
@@ -0,0 +1,53 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+/// A quick test of the positions a match can start at, used to skip hopeless start positions
+/// when searching for a match anywhere in a string.
+///
+/// A match can only start at a position whose character is consumed by one of the instructions
+/// reachable from the start of the program without consuming input. If the `Match` instruction
+/// is reachable this way, the regex can match the empty string, and any position is a candidate.
+/// The test ignores the repetition bounds checked at run time, so it may report false
+/// candidates, but it never rejects a position a match can start at.
+///
+/// If every match is known to start with a given literal (see `Prefilter::prefix`), only the
+/// occurrences of that literal are candidates.
+class StartFilter {
+public:
+    explicit StartFilter(const Program& program, std::u32string prefix = {});
+
+    /// Whether the regex may match the empty string.
+    bool matches_empty() const;
+
+    /// Find the first position not less than `from` that a match can start at, or
+    /// `std::nullopt` if there is none. `program` must be the program the filter has been built
+    /// from.
+    std::optional<size_t> next_candidate(
+        const Program& program,
+        std::u32string_view string,
+        size_t from) const;
+
+private:
+    bool can_start_with(const Program& program, char32_t c) const;
+
+    /// The character-consuming instructions reachable from the start of the program.
+    std::vector<size_t> m_start_pcs;
+    /// For each ASCII character, whether it is consumed by one of `m_start_pcs`.
+    std::bitset<128> m_ascii;
+    bool m_matches_empty = false;
+    std::u32string m_prefix;
+};
+
+}  // namespace wr22::regex_executor::program
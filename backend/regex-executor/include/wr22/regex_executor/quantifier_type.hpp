@@ -1,5 +1,9 @@
 #pragma once
 
+// stl
+#include <cstddef>
+#include <optional>
+
 namespace wr22::regex_executor {
 
 enum class QuantifierType {
@@ -8,4 +12,11 @@ enum class QuantifierType {
     Plus,
 };
 
+/// Get the minimum number of repetitions allowed by a quantifier.
+size_t min_repetitions(QuantifierType type);
+
+/// Get the maximum number of repetitions allowed by a quantifier, or `std::nullopt` if the
+/// number of repetitions is not bounded.
+std::optional<size_t> max_repetitions(QuantifierType type);
+
 }  // namespace wr22::regex_executor
@@ -1,8 +1,16 @@
 #pragma once
 
 // wr22
+#include <wr22/regex_executor/algorithms/bit_parallel/position_automaton.hpp>
+#include <wr22/regex_executor/algorithms/one_pass/automaton.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+#include <wr22/regex_executor/prefilter.hpp>
+#include <wr22/regex_executor/program/start_filter.hpp>
 #include <wr22/regex_parser/regex/part.hpp>
 
+// stl
+#include <optional>
+
 namespace wr22::regex_executor {
 
 class Regex {
@@ -10,9 +18,26 @@ public:
     explicit Regex(regex_parser::regex::SpannedPart root_part);
 
     const regex_parser::regex::SpannedPart& root_part() const;
+    /// The program the regex has been compiled into. See `program::compile`.
+    const program::Program& program() const;
+    /// The literals every match must contain.
+    const Prefilter& prefilter() const;
+    /// The filter of the positions a match of `program()` can start at.
+    const program::StartFilter& start_filter() const;
+    /// The one-pass automaton for `program()`, or `std::nullopt` if the regex is not one-pass.
+    const std::optional<algorithms::one_pass::Automaton>& one_pass_automaton() const;
+    /// The position automaton for `root_part()`, or `std::nullopt` if the regex has too many
+    /// positions for the bit-parallel algorithm.
+    const std::optional<algorithms::bit_parallel::PositionAutomaton>& bit_parallel_automaton()
+        const;
 
 private:
     regex_parser::regex::SpannedPart m_root_part;
+    program::Program m_program;
+    Prefilter m_prefilter;
+    program::StartFilter m_start_filter;
+    std::optional<algorithms::one_pass::Automaton> m_one_pass_automaton;
+    std::optional<algorithms::bit_parallel::PositionAutomaton> m_bit_parallel_automaton;
 };
 
 }
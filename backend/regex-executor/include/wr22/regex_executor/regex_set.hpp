@@ -0,0 +1,46 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/alphabet.hpp>
+#include <wr22/regex_executor/regex.hpp>
+#include <wr22/regex_parser/regex/part.hpp>
+
+// stl
+#include <cstddef>
+#include <vector>
+
+namespace wr22::regex_executor {
+
+/// A list of regexes compiled to be matched against the same strings at once.
+///
+/// Besides compiling each regex on its own, the set numbers the instructions of all their
+/// programs consecutively, as if the programs were laid out one after another, and partitions
+/// the characters with respect to all of them. An automaton whose states are sets of such
+/// instruction numbers (see `algorithms::lazy_dfa::SetExecutor`) then runs all the regexes in a
+/// single scan of a string.
+class RegexSet {
+public:
+    explicit RegexSet(std::vector<regex_parser::regex::SpannedPart> root_parts);
+
+    /// The number of regexes in the set.
+    size_t size() const;
+    const Regex& regex_at(size_t regex_index) const;
+    const std::vector<Regex>& regexes() const;
+
+    /// The total number of instructions in the programs of all the regexes.
+    size_t num_instructions() const;
+    /// The number of the first instruction of the program of a regex.
+    size_t program_offset(size_t regex_index) const;
+    /// The index of the regex whose program has the instruction with a given number.
+    size_t regex_index_of(size_t instruction_number) const;
+    /// The classes of characters that no program of the set tells apart.
+    const algorithms::lazy_dfa::Alphabet& alphabet() const;
+
+private:
+    std::vector<Regex> m_regexes;
+    /// `size() + 1` entries: the last one is `num_instructions()`.
+    std::vector<size_t> m_program_offsets;
+    algorithms::lazy_dfa::Alphabet m_alphabet;
+};
+
+}  // namespace wr22::regex_executor
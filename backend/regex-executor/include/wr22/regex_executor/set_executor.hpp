@@ -0,0 +1,39 @@
+#pragma once
+
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/set_executor.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/match_budget.hpp>
+#include <wr22/regex_executor/regex_set.hpp>
+#include <wr22/regex_executor/set_match_result.hpp>
+
+// stl
+#include <string_view>
+
+namespace wr22::regex_executor {
+
+/// Tells which regexes of a `RegexSet` match a string.
+///
+/// All the regexes are run at once by a lazy DFA combined from their programs (see
+/// `algorithms::lazy_dfa::SetExecutor`), so the time taken grows with the length of the string
+/// rather than with the number of regexes. If the combined DFA has too many states to be
+/// cached, each regex is matched with its own `Executor` instead.
+class SetExecutor {
+public:
+    explicit SetExecutor(const RegexSet& regex_set_ref);
+
+    const RegexSet& regex_set_ref() const;
+    /// Find the regexes matching a string. `Fragment::All` is treated like `Fragment::Search`:
+    /// a regex matches if the string has any match of it. `budget` limits the matching of each
+    /// regex when they are matched one by one; `BudgetExceeded` is thrown if it is exceeded.
+    SetMatchResult execute(
+        const std::u32string_view& string,
+        Fragment fragment = Fragment::Whole,
+        const MatchBudget& budget = {});
+
+private:
+    algorithms::lazy_dfa::SetExecutor m_lazy_dfa_executor;
+    algorithms::lazy_dfa::SetExecutor m_lazy_dfa_search_executor;
+};
+
+}  // namespace wr22::regex_executor
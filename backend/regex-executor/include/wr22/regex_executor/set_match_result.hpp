@@ -0,0 +1,23 @@
+#pragma once
+
+// stl
+#include <cstddef>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json_fwd.hpp>
+
+namespace wr22::regex_executor {
+
+/// The result of matching a string against all the regexes of a `RegexSet`.
+struct SetMatchResult {
+    /// The indices of the regexes that match the string, in ascending order.
+    std::vector<size_t> matched;
+    /// Whether all the regexes have been run at once by the combined automaton. If it has
+    /// grown too large, the regexes are matched one by one instead.
+    bool combined;
+};
+
+void to_json(nlohmann::json& j, const SetMatchResult& result);
+
+}  // namespace wr22::regex_executor
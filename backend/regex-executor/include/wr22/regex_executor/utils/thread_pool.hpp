@@ -0,0 +1,51 @@
+#pragma once
+
+// stl
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wr22::regex_executor::utils {
+
+/// A fixed set of threads that help the calls matching in parallel, so that these calls do not
+/// pay for starting threads of their own. The threads are started when they are first needed
+/// and wait for more work until the pool is destroyed.
+class ThreadPool {
+public:
+    /// Create a pool of `num_threads` threads.
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// The pool shared by the whole process, with a thread for every hardware thread but one,
+    /// which is left for the calling thread.
+    static ThreadPool& shared();
+
+    size_t num_threads() const;
+
+    /// Call `task(0)` on the calling thread and `task(i)` for every `i` from 1 to `num_helpers`
+    /// (at most `num_threads()`) on the threads of the pool, returning when all of them are
+    /// done. The calls that have not started by the time `task(0)` returns are skipped, so a
+    /// busy pool only makes the work less parallel: `task` must be able to do all of it alone.
+    /// `task` must not throw.
+    void run(size_t num_helpers, const std::function<void(size_t)>& task);
+
+private:
+    void start_threads();
+    void work();
+
+    size_t m_num_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::deque<std::function<void()>> m_queue;
+    bool m_stopping = false;
+    std::vector<std::jthread> m_threads;
+};
+
+}  // namespace wr22::regex_executor::utils
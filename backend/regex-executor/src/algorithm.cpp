@@ -0,0 +1,42 @@
+// wr22
+#include <wr22/regex_executor/algorithm.hpp>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+namespace wr22::regex_executor {
+
+const char* algorithm_name(Algorithm algorithm) {
+    switch (algorithm) {
+    case Algorithm::Backtracking:
+        return "backtracking";
+    case Algorithm::PikeVm:
+        return "pike_vm";
+    case Algorithm::LazyDfa:
+        return "lazy_dfa";
+    case Algorithm::OnePass:
+        return "one_pass";
+    case Algorithm::BitParallel:
+        return "bit_parallel";
+    }
+}
+
+std::optional<Algorithm> algorithm_from_name(std::string_view name) {
+    for (auto algorithm :
+         {Algorithm::Backtracking,
+          Algorithm::PikeVm,
+          Algorithm::LazyDfa,
+          Algorithm::OnePass,
+          Algorithm::BitParallel}) {
+        if (name == algorithm_name(algorithm)) {
+            return algorithm;
+        }
+    }
+    return std::nullopt;
+}
+
+void to_json(nlohmann::json& j, Algorithm algorithm) {
+    j = algorithm_name(algorithm);
+}
+
+}  // namespace wr22::regex_executor
@@ -1,52 +1,101 @@
 // wr22
 #include <wr22/regex_executor/algorithms/backtracking/decision.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/failure_reason.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/interpreter.hpp>
-#include <wr22/regex_parser/regex/part.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+
+// stl
+#include <variant>
 
 namespace wr22::regex_executor::algorithms::backtracking {
 
-namespace part = regex_parser::regex::part;
+namespace instruction = program::instruction;
 
-std::optional<AlternativesDecision> AlternativesDecision::reconsider(
-    Interpreter& interpreter,
-    InterpreterStateSnapshot snapshot) const {
-    if (decision_index + 1 >= part_ref.get().alternatives.size()) {
-        return std::nullopt;
+bool AlternativesDecision::reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot)
+    const {
+    const auto& alternatives = std::get<instruction::Alternatives>(
+        interpreter.program().instructions.at(pc).as_variant());
+    auto next_index = alternative_index + 1;
+    if (next_index >= alternatives.targets.size()) {
+        return false;
     }
 
-    auto new_decision = AlternativesDecision{
-        .part_ref = part_ref,
-        .initial_string_pos = initial_string_pos,
-        .decision_index = decision_index + 1,
-    };
     interpreter.restore_from_snapshot(std::move(snapshot));
-    return new_decision;
+    interpreter.add_decision(AlternativesDecision{.pc = pc, .alternative_index = next_index});
+    interpreter.jump(alternatives.targets.at(next_index));
+    return true;
 }
 
-template <typename PartT>
-std::optional<QuantifierDecision<PartT>> QuantifierDecision<PartT>::reconsider(
-    Interpreter& interpreter,
-    InterpreterStateSnapshot snapshot) const {
-    if (stop_here) {
-        return std::nullopt;
+void AlternativesDecision::finalize_exhausted(Interpreter& interpreter) const {
+    if (interpreter.records_steps()) {
+        interpreter.add_step(step::FinishAlternatives{
+            .regex_span = interpreter.program().spans.at(pc),
+            .result =
+                step::FinishAlternatives::Failure{
+                    .string_pos = interpreter.cursor(),
+                    .failure_reason = failure_reasons::OptionsExhausted{},
+                },
+        });
     }
-    if (!can_go_back) {
-        return std::nullopt;
+}
+
+bool QuantifierDecision::reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot)
+    const {
+    if (!exit_pc.has_value()) {
+        return false;
     }
-    auto new_decision = *this;
-    new_decision.stop_here = true;
+
     interpreter.restore_from_snapshot(std::move(snapshot));
-    return new_decision;
+    interpreter.jump(exit_pc.value());
+    return true;
+}
+
+void QuantifierDecision::finalize_exhausted(Interpreter& interpreter) const {
+    if (is_first && interpreter.records_steps()) {
+        const auto& begin = std::get<instruction::BeginQuantifier>(
+            interpreter.program().instructions.at(quantifier_pc).as_variant());
+        interpreter.add_step(step::FinishQuantifier{
+            .quantifier_type = begin.type,
+            .regex_span = interpreter.program().spans.at(quantifier_pc),
+            .result =
+                step::FinishQuantifier::Failure{
+                    .string_pos = interpreter.cursor(),
+                    .failure_reason = failure_reasons::OptionsExhausted{},
+                },
+        });
+    }
 }
 
-// Explicit instantiations.
-template std::optional<QuantifierDecision<part::Star>> QuantifierDecision<part::Star>::reconsider(
-    Interpreter&,
-    InterpreterStateSnapshot) const;
-template std::optional<QuantifierDecision<part::Plus>> QuantifierDecision<part::Plus>::reconsider(
-    Interpreter&,
-    InterpreterStateSnapshot) const;
-template std::optional<QuantifierDecision<part::Optional>> QuantifierDecision<
-    part::Optional>::reconsider(Interpreter&, InterpreterStateSnapshot) const;
+bool RunDecision::reconsider(Interpreter& interpreter, InterpreterStateSnapshot snapshot) const {
+    const auto& split = std::get<instruction::QuantifierSplit>(
+        interpreter.program().instructions.at(split_pc).as_variant());
+    auto end = snapshot.cursor;
+    while (end > min_end) {
+        --end;
+        if (interpreter.may_exit(split, end)) {
+            snapshot.cursor = end;
+            interpreter.restore_from_snapshot(std::move(snapshot));
+            if (end > min_end) {
+                interpreter.add_decision(RunDecision{.split_pc = split_pc, .min_end = min_end});
+            }
+            interpreter.jump(split.exit);
+            return true;
+        }
+    }
+    return false;
+}
+
+void RunDecision::finalize_exhausted([[maybe_unused]] Interpreter& interpreter) const {}
+
+bool FailureMark::reconsider(
+    [[maybe_unused]] Interpreter& interpreter,
+    [[maybe_unused]] InterpreterStateSnapshot snapshot) const {
+    return false;
+}
+
+void FailureMark::finalize_exhausted(Interpreter& interpreter) const {
+    interpreter.mark_failed(bit);
+}
 
 }  // namespace wr22::regex_executor::algorithms::backtracking
@@ -1,6 +1,5 @@
 // wr22
 #include <wr22/regex_executor/algorithms/backtracking/executor.hpp>
-#include <wr22/regex_executor/algorithms/backtracking/instruction.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/interpreter.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/match_failure.hpp>
 
@@ -12,8 +11,56 @@ const Regex& Executor::regex_ref() const {
     return m_regex_ref.get();
 }
 
-MatchResult Executor::execute(const std::u32string_view& string) const {
-    auto interpreter = Interpreter(regex_ref(), string);
+MatchResult Executor::execute(const std::u32string_view& string, const MatchOptions& options) {
+    if (!options.record_steps) {
+        return execute_into(string, options, nullptr);
+    }
+    auto step_sink = VectorStepSink();
+    auto result = execute_into(string, options, &step_sink);
+    result.steps = std::move(step_sink).into_steps();
+    return result;
+}
+
+MatchResult Executor::execute(
+    const std::u32string_view& string,
+    const MatchOptions& options,
+    StepSink& step_sink) {
+    return execute_into(string, options, &step_sink);
+}
+
+MatchResult Executor::execute_into(
+    const std::u32string_view& string,
+    const MatchOptions& options,
+    StepSink* step_sink) {
+    auto interpreter = Interpreter(regex_ref(), string, options, step_sink, m_scratch);
+
+    if (options.fragment == Fragment::All) {
+        // Reuse the same interpreter for all the matches.
+        auto matches = std::vector<Captures>();
+        try {
+            do {
+                while (!interpreter.finished()) {
+                    interpreter.run_instruction();
+                }
+                interpreter.finalize();
+                matches.push_back(interpreter.captures());
+            } while (interpreter.resume_after_match());
+        } catch (const MatchFailure&) {
+            interpreter.finalize_error();
+        }
+        if (matches.empty()) {
+            return MatchResult{
+                .matched = false,
+                .matches = std::move(matches),
+            };
+        }
+        auto first = matches.front();
+        return MatchResult{
+            .matched = true,
+            .captures = std::move(first),
+            .matches = std::move(matches),
+        };
+    }
 
     try {
         while (!interpreter.finished()) {
@@ -24,14 +71,12 @@ MatchResult Executor::execute(const std::u32string_view& string) const {
         interpreter.finalize_error();
         return MatchResult{
             .matched = false,
-            .steps = std::move(interpreter).into_steps(),
         };
     }
 
     return MatchResult{
         .matched = true,
-        .captures = std::move(interpreter.current_state().captures),
-        .steps = std::move(interpreter).into_steps(),
+        .captures = interpreter.captures(),
     };
 }
 
@@ -0,0 +1,348 @@
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/decision.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/failure_reason.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/instruction_executor.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step.hpp>
+#include <wr22/regex_executor/program/char_class.hpp>
+#include <wr22/regex_executor/quantifier_type.hpp>
+
+// stl
+#include <string_view>
+#include <variant>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+namespace instruction = program::instruction;
+using regex_parser::span::Span;
+
+namespace {
+    const instruction::BeginQuantifier& begin_quantifier_at(
+        const Interpreter& interpreter,
+        size_t quantifier_pc) {
+        return std::get<instruction::BeginQuantifier>(
+            interpreter.program().instructions.at(quantifier_pc).as_variant());
+    }
+}  // namespace
+
+InstructionExecutor::InstructionExecutor(Interpreter& interpreter, size_t pc)
+    : m_interpreter(interpreter), m_pc(pc) {}
+
+bool InstructionExecutor::operator()(const instruction::Literal& instruction) const {
+    if (instruction.run.has_value() && !m_interpreter.records_steps()) {
+        // Without the steps, the rest of the run of literals is compared at once.
+        const auto& run = instruction.run.value();
+        const auto& run_string = m_interpreter.program().literal_runs.at(run.string_index);
+        auto literal = std::u32string_view(run_string).substr(run.offset);
+        if (!m_interpreter.consume(literal)) {
+            return false;
+        }
+        m_interpreter.jump(m_pc + literal.size());
+        return true;
+    }
+
+    auto maybe_char = m_interpreter.current_char();
+    if (!maybe_char.has_value()) {
+        // Failure due to end of input.
+        if (m_interpreter.records_steps()) {
+            m_interpreter.add_step(step::MatchLiteral{
+                .regex_span = regex_span(),
+                .literal = instruction.character,
+                .result =
+                    step::MatchLiteral::Failure{
+                        .string_pos = m_interpreter.cursor(),
+                        .failure_reason = failure_reasons::EndOfInput{},
+                    },
+            });
+        }
+        return false;
+    }
+    auto c = maybe_char.value();
+    if (c != instruction.character) {
+        // Failure due to a wrong character.
+        if (m_interpreter.records_steps()) {
+            m_interpreter.add_step(step::MatchLiteral{
+                .regex_span = regex_span(),
+                .literal = instruction.character,
+                .result =
+                    step::MatchLiteral::Failure{
+                        .string_pos = m_interpreter.cursor(),
+                        .failure_reason = failure_reasons::OtherChar{},
+                    },
+            });
+        }
+        return false;
+    }
+
+    // Success.
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::MatchLiteral{
+            .regex_span = regex_span(),
+            .literal = instruction.character,
+            .result =
+                step::MatchLiteral::Success{
+                    .string_span = Span::make_single_position(m_interpreter.cursor()),
+                },
+        });
+    }
+    m_interpreter.advance();
+    return true;
+}
+
+bool InstructionExecutor::operator()(
+    [[maybe_unused]] const instruction::Wildcard& instruction) const {
+    auto maybe_char = m_interpreter.current_char();
+    if (!maybe_char.has_value()) {
+        // Failure due to end of input.
+        if (m_interpreter.records_steps()) {
+            m_interpreter.add_step(step::MatchWildcard{
+                .regex_span = regex_span(),
+                .result =
+                    step::MatchWildcard::Failure{
+                        .string_pos = m_interpreter.cursor(),
+                        .failure_reason = failure_reasons::EndOfInput{},
+                    },
+            });
+        }
+        return false;
+    }
+
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::MatchWildcard{
+            .regex_span = regex_span(),
+            .result =
+                step::MatchWildcard::Success{
+                    .string_span = Span::make_single_position(m_interpreter.cursor()),
+                },
+        });
+    }
+    m_interpreter.advance();
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::CharClass& instruction) const {
+    auto maybe_char = m_interpreter.current_char();
+    if (!maybe_char.has_value()) {
+        if (m_interpreter.records_steps()) {
+            m_interpreter.add_step(step::MatchCharClass{
+                .regex_span = regex_span(),
+                .result =
+                    step::MatchCharClass::Failure{
+                        .string_pos = m_interpreter.cursor(),
+                        .failure_reason = failure_reasons::EndOfInput{},
+                    },
+            });
+        }
+        return false;
+    }
+    auto c = maybe_char.value();
+    const auto& char_class = m_interpreter.program().char_classes.at(instruction.class_index);
+    if (!char_class.matches(c)) {
+        if (m_interpreter.records_steps()) {
+            m_interpreter.add_step(step::MatchCharClass{
+                .regex_span = regex_span(),
+                .result =
+                    step::MatchCharClass::Failure{
+                        .string_pos = m_interpreter.cursor(),
+                        .failure_reason = failure_reasons::ExcludedChar{},
+                    },
+            });
+        }
+        return false;
+    }
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::MatchCharClass{
+            .regex_span = regex_span(),
+            .result =
+                step::MatchCharClass::Success{
+                    .string_span = Span::make_single_position(m_interpreter.cursor()),
+                },
+        });
+    }
+    m_interpreter.advance();
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::Alternatives& instruction) const {
+    if (!m_interpreter.enter_decision_point(m_pc)) {
+        return false;
+    }
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::MatchAlternatives{
+            .regex_span = regex_span(),
+            .string_pos = m_interpreter.cursor(),
+        });
+    }
+    m_interpreter.set_register(instruction.position_register, m_interpreter.cursor());
+    m_interpreter.add_decision(AlternativesDecision{.pc = m_pc, .alternative_index = 0});
+    m_interpreter.jump(instruction.targets.at(0));
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::FinishAlternative& instruction) const {
+    if (m_interpreter.records_steps()) {
+        const auto& alternatives = std::get<instruction::Alternatives>(
+            m_interpreter.program().instructions.at(instruction.alternatives_pc).as_variant());
+        auto begin = m_interpreter.register_at(alternatives.position_register);
+        m_interpreter.add_step(step::FinishAlternatives{
+            .regex_span = regex_span(),
+            .result =
+                step::FinishAlternatives::Success{
+                    .string_span = Span::make_from_positions(begin, m_interpreter.cursor()),
+                    .alternative_chosen = instruction.alternative_index,
+                },
+        });
+    }
+    m_interpreter.jump(instruction.target);
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::BeginGroup& instruction) const {
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::BeginGroup{
+            .regex_span = regex_span(),
+            .string_pos = m_interpreter.cursor(),
+        });
+    }
+    m_interpreter.set_register(instruction.position_register, m_interpreter.cursor());
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::EndGroup& instruction) const {
+    auto begin = m_interpreter.register_at(instruction.position_register);
+    auto end = m_interpreter.cursor();
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::EndGroup{
+            .string_pos = end,
+        });
+    }
+
+    if (instruction.capture_slot.has_value()) {
+        m_interpreter.set_capture(instruction.capture_slot.value(), begin, end);
+    }
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::BeginQuantifier& instruction) const {
+    if (m_interpreter.records_steps()) {
+        m_interpreter.add_step(step::MatchQuantifier{
+            .regex_span = regex_span(),
+            .string_pos = m_interpreter.cursor(),
+            .quantifier_type = instruction.type,
+        });
+    }
+    m_interpreter.set_register(instruction.counter_register, 0);
+    m_interpreter.set_register(instruction.position_register, m_interpreter.cursor());
+    m_interpreter.set_register(instruction.iteration_register, m_interpreter.cursor());
+
+    if (min_repetitions(instruction.type) > 0 && m_interpreter.records_steps()) {
+        // The first repetition is mandatory and is matched without a `QuantifierSplit`. Still
+        // make a decision that cannot be reconsidered, so that a failure to match the first
+        // repetition is reported as the quantifier's failure in the steps.
+        m_interpreter.add_decision(QuantifierDecision{
+            .quantifier_pc = m_pc,
+            .exit_pc = std::nullopt,
+            .is_first = true,
+        });
+    }
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::QuantifierSplit& instruction) const {
+    if (!m_interpreter.enter_decision_point(m_pc)) {
+        return false;
+    }
+    const auto& begin = begin_quantifier_at(m_interpreter, instruction.quantifier_pc);
+    auto num_repetitions_so_far = m_interpreter.register_at(begin.counter_register);
+    auto can_stop = num_repetitions_so_far + 1 > min_repetitions(begin.type);
+
+    if (instruction.single_char_body && can_stop && !m_interpreter.records_steps()
+        && !m_interpreter.memoizes()) {
+        return match_run(instruction);
+    }
+
+    m_interpreter.set_register(begin.iteration_register, m_interpreter.cursor());
+    // Without the steps, a decision is only worth making if it can be reconsidered: stopping
+    // here must be allowed and must have a chance to lead to a match. The steps show every
+    // option, even a hopeless one.
+    if (!m_interpreter.records_steps()
+        && (!can_stop || !m_interpreter.may_exit(instruction, m_interpreter.cursor()))) {
+        m_interpreter.jump(instruction.body);
+        return true;
+    }
+    m_interpreter.add_decision(QuantifierDecision{
+        .quantifier_pc = instruction.quantifier_pc,
+        .exit_pc = can_stop ? std::optional<size_t>(instruction.exit) : std::nullopt,
+        .is_first = num_repetitions_so_far == 0,
+    });
+    m_interpreter.jump(instruction.body);
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::EndIteration& instruction) const {
+    const auto& begin = begin_quantifier_at(m_interpreter, instruction.quantifier_pc);
+    auto num_repetitions = m_interpreter.register_at(begin.counter_register);
+
+    // Break infinite loops if detected. Only makes sense when the upper bound on the number
+    // of matches is not set.
+    if (!max_repetitions(begin.type).has_value() && num_repetitions >= min_repetitions(begin.type)
+        && m_interpreter.cursor() == m_interpreter.register_at(begin.iteration_register)) {
+        return false;
+    }
+
+    m_interpreter.set_register(begin.counter_register, num_repetitions + 1);
+    m_interpreter.jump(instruction.target);
+    return true;
+}
+
+bool InstructionExecutor::operator()(const instruction::EndQuantifier& instruction) const {
+    if (m_interpreter.records_steps()) {
+        const auto& begin = begin_quantifier_at(m_interpreter, instruction.quantifier_pc);
+        auto span_begin = m_interpreter.register_at(begin.position_register);
+        m_interpreter.add_step(step::FinishQuantifier{
+            .quantifier_type = begin.type,
+            .regex_span = regex_span(),
+            .result =
+                step::FinishQuantifier::Success{
+                    .string_span = Span::make_from_positions(span_begin, m_interpreter.cursor()),
+                    .num_repetitions = m_interpreter.register_at(begin.counter_register),
+                },
+        });
+    }
+    return true;
+}
+
+bool InstructionExecutor::operator()([[maybe_unused]] const instruction::Match& instruction) const {
+    if (!m_interpreter.searching() && m_interpreter.cursor() != m_interpreter.string_length()) {
+        return false;
+    }
+    m_interpreter.finish();
+    return true;
+}
+
+bool InstructionExecutor::match_run(const instruction::QuantifierSplit& instruction) const {
+    // Match the longest run at once, then stop at its last position where stopping may lead to
+    // a match. A single decision stands for all the shorter runs.
+    // The split of an optional item is only reached before its single repetition.
+    const auto& begin = begin_quantifier_at(m_interpreter, instruction.quantifier_pc);
+    auto max_length = max_repetitions(begin.type).value_or(std::u32string_view::npos);
+    auto run_begin = m_interpreter.cursor();
+    auto end = run_begin + m_interpreter.run_length(instruction.body, max_length);
+    while (!m_interpreter.may_exit(instruction, end)) {
+        if (end == run_begin) {
+            return false;
+        }
+        --end;
+    }
+    m_interpreter.advance(end - run_begin);
+    if (end > run_begin) {
+        m_interpreter.add_decision(RunDecision{.split_pc = m_pc, .min_end = run_begin});
+    }
+    m_interpreter.jump(instruction.exit);
+    return true;
+}
+
+Span InstructionExecutor::regex_span() const {
+    return m_interpreter.program().spans.at(m_pc);
+}
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -1,36 +1,90 @@
 // wr22
-#include <wr22/regex_executor/algorithms/backtracking/decision_applicator.hpp>
-#include <wr22/regex_executor/algorithms/backtracking/instruction.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/instruction_executor.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/interpreter.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/match_failure.hpp>
-#include <wr22/regex_executor/algorithms/backtracking/part_executor.hpp>
 #include <wr22/regex_executor/algorithms/backtracking/step.hpp>
-#include <wr22/regex_executor/utils/spanned_ref.hpp>
-#include <wr22/regex_parser/regex/part.hpp>
-#include <wr22/unicode/conversion.hpp>
+#include <wr22/regex_executor/program/char_class.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/program/run_length.hpp>
 
-// fmt
-#include <fmt/compile.h>
-#include <fmt/core.h>
+// stl
+#include <algorithm>
+#include <cstring>
+#include <variant>
 
 namespace wr22::regex_executor::algorithms::backtracking {
 
-Interpreter::Interpreter(const Regex& regex, const std::u32string_view& string_ref)
-    : m_string_ref(string_ref),
-      m_current_state(InterpreterState{
-          .captures =
-              Captures{
-                  .whole =
-                      Capture{
-                          .string_span = regex_parser::span::Span::make_empty(0),
-                      },
-              },
-      }) {
-    auto ref = utils::SpannedRef<regex_parser::regex::Part>(
-        regex.root_part().part(),
-        regex.root_part().span());
-    m_current_state.instructions.push_back(instruction::ExpectEnd{});
-    m_current_state.instructions.push_back(instruction::Execute{ref});
+Interpreter::Interpreter(
+    const Regex& regex,
+    const std::u32string_view& string_ref,
+    const MatchOptions& options,
+    StepSink* step_sink,
+    MatchScratch& scratch)
+    : m_program(regex.program()), m_start_filter(regex.start_filter()), m_string_ref(string_ref),
+      m_step_sink(step_sink), m_searching(options.fragment != Fragment::Whole),
+      m_decision_points(scratch.decision_points),
+      m_enclosing_quantifiers(scratch.enclosing_quantifiers), m_failed(scratch.failed),
+      m_current_state(scratch.state), m_trail(scratch.trail),
+      m_decision_snapshots(scratch.decision_snapshots), m_budget(options.budget) {
+    // Reset the buffers left over from an earlier run, keeping their capacity.
+    m_current_state.cursor = 0;
+    m_current_state.pc = 0;
+    m_current_state.registers.assign(m_program.num_registers, 0);
+    m_current_state.capture_positions.assign(
+        m_program.capture_slots.size() * 2,
+        program::unset_capture_position);
+    m_trail.clear();
+    m_decision_snapshots.clear();
+    m_decision_points.clear();
+    m_enclosing_quantifiers.clear();
+    m_failed.clear();
+
+    if (options.memoize) {
+        const auto& instructions = m_program.instructions;
+        auto num_decision_points = size_t(0);
+        // The quantifiers begun but not yet ended before the current instruction.
+        auto open_quantifiers = std::vector<size_t>();
+        m_decision_points.reserve(instructions.size());
+        for (size_t pc = 0; pc < instructions.size(); ++pc) {
+            const auto& variant = instructions[pc].as_variant();
+            if (std::holds_alternative<program::instruction::BeginQuantifier>(variant)) {
+                open_quantifiers.push_back(pc);
+            } else if (std::holds_alternative<program::instruction::EndQuantifier>(variant)) {
+                open_quantifiers.pop_back();
+            }
+
+            const auto* split = std::get_if<program::instruction::QuantifierSplit>(&variant);
+            if (split == nullptr
+                && !std::holds_alternative<program::instruction::Alternatives>(variant)) {
+                m_decision_points.push_back(std::nullopt);
+                continue;
+            }
+            auto quantifiers_begin = m_enclosing_quantifiers.size();
+            for (auto quantifier_pc : open_quantifiers) {
+                const auto& begin = std::get<program::instruction::BeginQuantifier>(
+                    instructions.at(quantifier_pc).as_variant());
+                // A split is not a part of the body of its own quantifier.
+                auto own = split != nullptr && split->quantifier_pc == quantifier_pc;
+                if (!own && !max_repetitions(begin.type).has_value()) {
+                    m_enclosing_quantifiers.push_back(quantifier_pc);
+                }
+            }
+            m_decision_points.push_back(DecisionPoint{
+                .index = num_decision_points++,
+                .quantifiers_begin = quantifiers_begin,
+                .quantifiers_end = m_enclosing_quantifiers.size(),
+            });
+        }
+        m_failed.resize(num_decision_points * (string_ref.size() + 1));
+    }
+    if (m_searching) {
+        start_at(
+            m_start_filter.next_candidate(m_program, m_string_ref, 0).value_or(string_ref.size()));
+    }
+}
+
+const program::Program& Interpreter::program() const {
+    return m_program;
 }
 
 std::optional<char32_t> Interpreter::current_char() const {
@@ -40,233 +94,367 @@ std::optional<char32_t> Interpreter::current_char() const {
     return m_string_ref[m_current_state.cursor];
 }
 
-void Interpreter::advance() {
-    ++m_current_state.cursor;
+void Interpreter::advance(size_t count) {
+    m_current_state.cursor += count;
+    m_statistics.max_string_pos = std::max(m_statistics.max_string_pos, m_current_state.cursor);
 }
 
-DecisionRef Interpreter::add_decision(
-    Decision decision,
-    utils::SpannedRef<regex_parser::regex::Part> decision_making_part) {
-    auto index = m_decision_snapshots.size();
-    auto snapshot = InterpreterStateSnapshot{
-        .state = m_current_state,
-        .decision_making_part = decision_making_part,
-        .before_step = m_steps.size(),
-    };
-    auto decision_snapshot = DecisionSnapshot{
-        .snapshot = std::move(snapshot),
-        .decision = std::move(decision),
-    };
-    m_decision_snapshots.push_back(std::move(decision_snapshot));
-    return DecisionRef{.index = index};
+size_t Interpreter::run_length(size_t pc, size_t max_length) const {
+    auto rest = m_string_ref.substr(m_current_state.cursor, max_length);
+    return m_program.instructions.at(pc).visit(
+        [rest](const program::instruction::Literal& instruction) {
+            return program::literal_run_length(rest, instruction.character);
+        },
+        [rest]([[maybe_unused]] const program::instruction::Wildcard& instruction) {
+            return rest.size();
+        },
+        [rest, this](const program::instruction::CharClass& instruction) {
+            return program::class_run_length(
+                rest,
+                m_program.char_classes.at(instruction.class_index));
+        },
+        []([[maybe_unused]] const auto& instruction) { return size_t(0); });
 }
 
-const DecisionSnapshot& Interpreter::decision_snapshot_at(DecisionRef ref) const {
-    return m_decision_snapshots.at(ref.index);
+bool Interpreter::consume(std::u32string_view literal) {
+    auto cursor = m_current_state.cursor;
+    if (m_string_ref.size() - cursor < literal.size()
+        || std::memcmp(
+               m_string_ref.data() + cursor,
+               literal.data(),
+               literal.size() * sizeof(char32_t))
+               != 0) {
+        return false;
+    }
+    m_current_state.cursor += literal.size();
+    m_statistics.max_string_pos = std::max(m_statistics.max_string_pos, m_current_state.cursor);
+    return true;
 }
 
-DecisionSnapshot& Interpreter::decision_snapshot_at(DecisionRef ref) {
-    return m_decision_snapshots.at(ref.index);
+size_t Interpreter::cursor() const {
+    return m_current_state.cursor;
 }
 
-void Interpreter::restore_from_snapshot(InterpreterStateSnapshot snapshot) {
-    add_step(step::Backtrack{
-        .string_pos = cursor(),
-        .continue_after_step = snapshot.before_step - 1,
-    });
-    m_current_state = std::move(snapshot.state);
+size_t Interpreter::string_length() const {
+    return m_string_ref.length();
 }
 
-void Interpreter::push_mini_snapshot() {
-    m_mini_snapshots.push(InterpreterStateMiniSnapshot{
-        .cursor = cursor(),
-        .before_step = m_steps.size(),
-    });
+bool Interpreter::searching() const {
+    return m_searching;
 }
 
-void Interpreter::pop_mini_snapshot() {
-    m_mini_snapshots.pop();
+size_t Interpreter::pc() const {
+    return m_current_state.pc;
 }
 
-std::optional<std::reference_wrapper<const InterpreterStateMiniSnapshot>> Interpreter::
-    last_mini_snapshot() const {
-    if (m_mini_snapshots.empty()) {
-        return std::nullopt;
-    } else {
-        return std::cref(m_mini_snapshots.top());
+void Interpreter::jump(size_t pc) {
+    m_current_state.pc = pc;
+}
+
+void Interpreter::add_decision(Decision decision) {
+    ++m_statistics.decisions;
+    auto snapshot = InterpreterStateSnapshot{
+        .trail_mark = m_trail.size(),
+        .cursor = m_current_state.cursor,
+        .before_step = m_num_steps,
+    };
+    m_decision_snapshots.push_back(DecisionSnapshot{
+        .snapshot = std::move(snapshot),
+        .decision = std::move(decision),
+    });
+}
+
+void Interpreter::restore_from_snapshot(InterpreterStateSnapshot snapshot) {
+    if (records_steps()) {
+        add_step(step::Backtrack{
+            .string_pos = cursor(),
+            .continue_after_step = snapshot.before_step - 1,
+        });
     }
+    unwind_trail(snapshot.trail_mark);
+    m_current_state.cursor = snapshot.cursor;
 }
 
-void Interpreter::add_instruction(Instruction instruction) {
-    m_current_state.instructions.push_back(std::move(instruction));
+bool Interpreter::enter_decision_point(size_t pc) {
+    if (m_decision_points.empty()) {
+        return true;
+    }
+    const auto& decision_point = m_decision_points.at(pc);
+    if (!decision_point.has_value()) {
+        return true;
+    }
+    auto bit = decision_point->index * (m_string_ref.size() + 1) + cursor();
+    if (m_failed.at(bit)) {
+        return false;
+    }
+    // A quantifier that rejects empty repetitions only adds ways to fail, so a failure found
+    // without any of them carries over to every other way of reaching this pair.
+    if (!may_reject_empty_iteration(decision_point.value())) {
+        auto snapshot = InterpreterStateSnapshot{
+            .trail_mark = m_trail.size(),
+            .cursor = m_current_state.cursor,
+            .before_step = m_num_steps,
+        };
+        m_decision_snapshots.push_back(DecisionSnapshot{
+            .snapshot = std::move(snapshot),
+            .decision = FailureMark{.bit = bit},
+        });
+    }
+    return true;
 }
 
-void Interpreter::add_step(Step step) {
-    m_steps.push_back(std::move(step));
+void Interpreter::mark_failed(size_t bit) {
+    m_failed.at(bit) = true;
 }
 
-void Interpreter::push_counter(size_t initial) {
-    m_current_state.counters.push_back(initial);
+bool Interpreter::memoizes() const {
+    return !m_decision_points.empty();
 }
 
-void Interpreter::pop_counter() {
-    m_current_state.counters.pop_back();
+bool Interpreter::may_reject_empty_iteration(const DecisionPoint& decision_point) const {
+    for (auto i = decision_point.quantifiers_begin; i < decision_point.quantifiers_end; ++i) {
+        const auto& begin = std::get<program::instruction::BeginQuantifier>(
+            m_program.instructions.at(m_enclosing_quantifiers[i]).as_variant());
+        if (register_at(begin.counter_register) >= min_repetitions(begin.type)
+            && register_at(begin.iteration_register) == cursor()) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void Interpreter::push_error_hook(ErrorHook hook) {
-    m_current_state.error_hooks.push(std::move(hook));
+bool Interpreter::may_exit(const program::instruction::QuantifierSplit& split, size_t position)
+    const {
+    if (!split.exit_follow.has_value()) {
+        return true;
+    }
+    const auto& exit_follow = split.exit_follow.value();
+    if (position >= m_string_ref.size()) {
+        return exit_follow.may_match;
+    }
+    if (exit_follow.may_match && m_searching) {
+        return true;
+    }
+    const auto& char_class = m_program.char_classes.at(exit_follow.class_index);
+    return char_class.matches(m_string_ref[position]);
 }
 
-void Interpreter::pop_error_hook() {
-    m_current_state.error_hooks.pop();
+bool Interpreter::records_steps() const {
+    return m_step_sink != nullptr;
 }
 
-size_t& Interpreter::counter_at_offset(size_t offset) {
-    auto index = parse_counter_offset(offset);
-    return m_current_state.counters.at(index);
+void Interpreter::add_step(Step step) {
+    ++m_num_steps;
+    m_step_sink->consume(std::move(step));
 }
 
-size_t Interpreter::counter_at_offset(size_t offset) const {
-    auto index = parse_counter_offset(offset);
-    return m_current_state.counters.at(index);
+size_t Interpreter::register_at(size_t index) const {
+    return m_current_state.registers.at(index);
 }
 
-size_t Interpreter::cursor() const {
-    return m_current_state.cursor;
+void Interpreter::set_register(size_t index, size_t value) {
+    auto& reg = m_current_state.registers.at(index);
+    record(trail_entry::SetRegister{.index = index, .value = reg});
+    reg = value;
 }
 
 bool Interpreter::finished() const {
-    return m_current_state.instructions.empty();
+    return m_finished;
 }
 
-void Interpreter::run_instruction() {
-    auto instruction = std::move(m_current_state.instructions.back());
-    m_current_state.instructions.pop_back();
-
-    auto ok = instruction.visit(
-        [this](const instruction::AddStep& instruction) {
-            add_step(std::move(instruction.step));
-            return true;
-        },
-        [this](const instruction::Execute& instruction) {
-            if (instruction.forced_decision.has_value()) {
-                return instruction.forced_decision.value().visit(
-                    [this, part = instruction.part](const auto& decision) {
-                        using DecisionType = std::remove_cvref_t<decltype(decision)>;
-                        using ApplicatorType = DecisionApplicator<DecisionType>;
-                        using PartType = typename DecisionType::PartType;
-                        auto specific_part = utils::SpannedRef<PartType>(
-                            std::get<PartType>(part.item().as_variant()),
-                            part.span());
-                        auto executor = ApplicatorType::construct_executor(
-                            specific_part,
-                            part,
-                            decision);
-                        return executor.execute(*this);
-                    });
-            } else {
-                auto executor = PartExecutor(instruction.part);
-                return executor.execute(*this);
-            }
-        },
-        [this](const instruction::Run& instruction) {
-            return instruction(*this);
-        },
-        [this](const instruction::ExpectEnd& instruction) {
-            return cursor() == m_string_ref.length();
-        });
+void Interpreter::finish() {
+    m_finished = true;
+}
 
-    if (ok) {
-        return;
+void Interpreter::run_instruction() {
+    ++m_statistics.steps;
+    if (--m_instructions_until_check == 0) {
+        check_budget();
     }
 
-    // Reconsider the decision if matching failed.
-
-    // Run the topmost error hook if any.
-    if (!m_current_state.error_hooks.empty()) {
-        const auto& hook = m_current_state.error_hooks.top();
-        hook(*this);
-        // No need to pop the hook, as `<DecisionType>::reconsider()` will take care of it.
+    auto pc = m_current_state.pc;
+    m_current_state.pc = pc + 1;
+    auto ok = m_program.instructions.at(pc).visit(InstructionExecutor(*this, pc));
+    if (!ok) {
+        backtrack();
     }
+}
 
+void Interpreter::backtrack() {
     // If we can reconsider a decision we have made earlier, do so.
     // We might need to go arbitrarily deep into the decision stack, since some decisions
     // we have made may have no more options remaining.
     while (true) {
         if (m_decision_snapshots.empty()) {
-            throw MatchFailure{};
+            if (!restart_at_next_candidate()) {
+                throw MatchFailure{};
+            }
+            return;
         }
 
         auto last_decision_snapshot = std::move(m_decision_snapshots.back());
         m_decision_snapshots.pop_back();
-        auto decision_making_part = last_decision_snapshot.snapshot.decision_making_part;
         auto has_reconsidered = last_decision_snapshot.decision.visit(
-            [this, snapshot = std::move(last_decision_snapshot.snapshot)](auto& decision) {
-                using DecisionType = std::decay_t<decltype(decision)>;
-
-                auto decision_making_part = snapshot.decision_making_part;
-                auto new_decision = decision.reconsider(*this, std::move(snapshot));
-                if (!new_decision.has_value()) {
-                    // Options exhausted for this decision, try the next one.
-                    using ApplicatorType = DecisionApplicator<DecisionType>;
-                    auto specific_ref = utils::SpannedRef(
-                        std::get<typename ApplicatorType::PartType>(
-                            decision_making_part.item().as_variant()),
-                        decision_making_part.span());
-                    ApplicatorType::finalize_exhausted(decision, specific_ref, *this);
-                    return false;
+            [this, snapshot = std::move(last_decision_snapshot.snapshot)](const auto& decision) {
+                if (decision.reconsider(*this, std::move(snapshot))) {
+                    return true;
                 }
-                decision = std::move(new_decision.value());
-                return true;
+                // Options exhausted for this decision, try the next one.
+                decision.finalize_exhausted(*this);
+                return false;
             });
 
         if (has_reconsidered) {
-            m_current_state.instructions.push_back(instruction::Execute{
-                .part = decision_making_part,
-                .forced_decision = std::move(last_decision_snapshot.decision),
-            });
             break;
         }
     }
 }
 
+bool Interpreter::restart_at_next_candidate() {
+    if (!m_searching || m_start == m_string_ref.size()) {
+        return false;
+    }
+    // The memoized (decision point, position) pairs stay valid: whether they fail does not
+    // depend on the position the match has started at.
+    auto next = m_start_filter.next_candidate(m_program, m_string_ref, m_start + 1);
+    if (!next.has_value()) {
+        return false;
+    }
+    start_at(next.value());
+    return true;
+}
+
+void Interpreter::start_at(size_t position) {
+    m_start = position;
+    m_current_state.pc = 0;
+    m_current_state.cursor = position;
+    std::fill(m_current_state.registers.begin(), m_current_state.registers.end(), 0);
+    std::fill(
+        m_current_state.capture_positions.begin(),
+        m_current_state.capture_positions.end(),
+        program::unset_capture_position);
+    m_trail.clear();
+}
+
+void Interpreter::check_budget() {
+    m_instructions_until_check = MatchBudget::check_interval;
+    m_statistics.memory = std::max(m_statistics.memory, memory_usage());
+
+    if (m_budget.max_steps.has_value() && m_statistics.steps > m_budget.max_steps.value()) {
+        throw BudgetExceeded(BudgetExceeded::Reason::Steps, m_statistics);
+    }
+    if (m_budget.max_decisions.has_value()
+        && m_statistics.decisions > m_budget.max_decisions.value()) {
+        throw BudgetExceeded(BudgetExceeded::Reason::Decisions, m_statistics);
+    }
+    if (m_budget.max_memory.has_value() && m_statistics.memory > m_budget.max_memory.value()) {
+        throw BudgetExceeded(BudgetExceeded::Reason::Memory, m_statistics);
+    }
+    if (m_budget.deadline.has_value()
+        && std::chrono::steady_clock::now() > m_budget.deadline.value()) {
+        throw BudgetExceeded(BudgetExceeded::Reason::Deadline, m_statistics);
+    }
+}
+
+size_t Interpreter::memory_usage() const {
+    // The sizes of the scratch buffers are counted rather than their capacities, so that the
+    // capacity left over from earlier runs does not count against this one.
+    auto step_sink_memory = records_steps() ? m_step_sink->memory_usage() : 0;
+    return m_current_state.registers.size() * sizeof(size_t)
+        + m_current_state.capture_positions.size() * sizeof(size_t)
+        + m_trail.size() * sizeof(TrailEntry)
+        + m_decision_snapshots.size() * sizeof(DecisionSnapshot) + step_sink_memory
+        + m_failed.size() / 8
+        + m_decision_points.size() * sizeof(std::optional<DecisionPoint>)
+        + m_enclosing_quantifiers.size() * sizeof(size_t);
+}
+
 void Interpreter::finalize() {
-    add_step(step::End{
-        .string_pos = cursor(),
-        .result = step::End::Success{},
-    });
-    m_current_state.captures.whole.string_span = regex_parser::span::Span::make_from_positions(
-        0,
-        cursor());
+    if (records_steps()) {
+        add_step(step::End{
+            .string_pos = cursor(),
+            .result = step::End::Success{},
+        });
+    }
 }
 
 void Interpreter::finalize_error() {
-    add_step(step::End{
-        .string_pos = cursor(),
-        .result = step::End::Failure{},
+    if (records_steps()) {
+        add_step(step::End{
+            .string_pos = cursor(),
+            .result = step::End::Failure{},
+        });
+    }
+}
+
+bool Interpreter::resume_after_match() {
+    auto end = cursor();
+    // After an empty match, skip a character so as not to find the same match again.
+    auto from = end == m_start ? end + 1 : end;
+    if (from > m_string_ref.size()) {
+        return false;
+    }
+    auto next = m_start_filter.next_candidate(m_program, m_string_ref, from);
+    if (!next.has_value()) {
+        return false;
+    }
+
+    m_finished = false;
+    // The memoized pairs have failed regardless of the match, so they are kept.
+    m_decision_snapshots.clear();
+    start_at(next.value());
+    return true;
+}
+
+void Interpreter::set_capture(size_t slot, size_t begin, size_t end) {
+    auto& positions = m_current_state.capture_positions;
+    record(trail_entry::SetCapture{
+        .slot = slot,
+        .begin = positions.at(slot * 2),
+        .end = positions.at(slot * 2 + 1),
     });
+    positions.at(slot * 2) = begin;
+    positions.at(slot * 2 + 1) = end;
 }
 
-void Interpreter::add_indexed_capture(Capture capture) {
-    auto index = m_current_state.capture_counter;
-    m_current_state.captures.indexed.insert({index, capture});
-    ++m_current_state.capture_counter;
+Captures Interpreter::captures() const {
+    auto whole = Capture{
+        .string_span = regex_parser::span::Span::make_from_positions(m_start, cursor()),
+    };
+    return program::make_captures(m_program, whole, m_current_state.capture_positions);
 }
 
-void Interpreter::add_named_capture(std::string_view name, Capture capture) {
-    m_current_state.captures.named.insert_or_assign(name, capture);
+bool Interpreter::trail_active() const {
+    // If there are no decisions to return to, no snapshot can ever be restored, so there is no
+    // need to record anything.
+    return !m_decision_snapshots.empty();
 }
 
-size_t Interpreter::parse_counter_offset(size_t offset) const {
-    auto size = m_current_state.counters.size();
-    if (offset >= size) {
-        throw std::out_of_range(fmt::format(FMT_STRING("No counter at offset {} exists"), offset));
+void Interpreter::record(TrailEntry entry) {
+    if (trail_active()) {
+        m_trail.push_back(std::move(entry));
     }
-    return size - offset - 1;
 }
 
-std::vector<Step> Interpreter::into_steps() && {
-    return std::move(m_steps);
+void Interpreter::unwind_trail(size_t mark) {
+    auto& state = m_current_state;
+    while (m_trail.size() > mark) {
+        auto entry = std::move(m_trail.back());
+        m_trail.pop_back();
+        entry.visit(
+            [&state](trail_entry::SetRegister& entry) {
+                state.registers.at(entry.index) = entry.value;
+            },
+            [&state](trail_entry::SetCapture& entry) {
+                state.capture_positions.at(entry.slot * 2) = entry.begin;
+                state.capture_positions.at(entry.slot * 2 + 1) = entry.end;
+            });
+    }
+
+    if (m_decision_snapshots.empty()) {
+        // Entries below the mark can only be needed by the decisions that no longer exist.
+        m_trail.clear();
+    }
 }
 
 const InterpreterState& Interpreter::current_state() const {
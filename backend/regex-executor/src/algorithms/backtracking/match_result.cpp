@@ -12,7 +12,12 @@ void to_json(nlohmann::json& j, const MatchResult& result) {
     if (result.captures.has_value()) {
         j["captures"] = result.captures.value();
     }
-    j["steps"] = result.steps;
+    if (result.matches.has_value()) {
+        j["matches"] = result.matches.value();
+    }
+    if (result.steps.has_value()) {
+        j["steps"] = result.steps.value();
+    }
 }
 
 }  // namespace wr22::regex_executor::algorithms::backtracking
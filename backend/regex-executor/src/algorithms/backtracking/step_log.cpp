@@ -0,0 +1,415 @@
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/step_log.hpp>
+#include <wr22/regex_executor/quantifier_type.hpp>
+
+// stl
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+using regex_parser::span::Span;
+
+namespace {
+    /// The type of a step, stored in the lower bits of its tag byte.
+    enum class StepType : uint8_t {
+        MatchQuantifier,
+        FinishQuantifier,
+        MatchCharClass,
+        MatchLiteral,
+        MatchWildcard,
+        BeginGroup,
+        EndGroup,
+        MatchAlternatives,
+        FinishAlternatives,
+        Backtrack,
+        End,
+    };
+
+    /// The outcome of a step is stored in the upper bits of its tag byte: 0 for a success or
+    /// a step that cannot fail, `1 + i` for a failure with the `i`-th possible failure reason.
+    constexpr uint8_t outcome_shift = 4;
+    constexpr uint8_t step_type_mask = (1 << outcome_shift) - 1;
+
+    /// Append an unsigned LEB128 integer: 7 bits per byte, the high bit telling whether more
+    /// bytes follow.
+    void write_varint(std::vector<uint8_t>& bytes, uint64_t value) {
+        while (value >= 0x80) {
+            bytes.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    class Reader {
+    public:
+        Reader(const std::vector<uint8_t>& bytes, size_t offset)
+            : m_bytes(bytes), m_offset(offset) {}
+
+        uint8_t read_byte() {
+            return m_bytes.get()[m_offset++];
+        }
+
+        uint64_t read_varint() {
+            auto value = uint64_t(0);
+            auto shift = 0;
+            while (true) {
+                auto byte = read_byte();
+                value |= uint64_t(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) {
+                    return value;
+                }
+                shift += 7;
+            }
+        }
+
+        Span read_string_span() {
+            auto begin = read_varint();
+            auto length = read_varint();
+            return Span::make_with_length(begin, length);
+        }
+
+        size_t offset() const {
+            return m_offset;
+        }
+
+    private:
+        std::reference_wrapper<const std::vector<uint8_t>> m_bytes;
+        size_t m_offset;
+    };
+
+    template <typename Result>
+    uint8_t outcome_of(const Result& result) {
+        return result.visit([](const auto& outcome) -> uint8_t {
+            using Outcome = std::decay_t<decltype(outcome)>;
+            if constexpr (Outcome::success) {
+                return 0;
+            } else if constexpr (requires { outcome.failure_reason; }) {
+                return 1 + outcome.failure_reason.reason.as_variant().index();
+            } else {
+                return 1;
+            }
+        });
+    }
+
+    template <typename Reason>
+    struct ReasonDecoder;
+
+    template <typename... Reasons>
+    struct ReasonDecoder<FailureReason<Reasons...>> {
+        static FailureReason<Reasons...> decode(size_t index) {
+            auto reason = std::optional<FailureReason<Reasons...>>();
+            auto i = size_t(0);
+            ((i++ == index ? (void)reason.emplace(Reasons{}) : (void)0), ...);
+            return std::move(reason).value();
+        }
+    };
+
+    /// Decode the result of a step whose success is described by the string span matched and
+    /// whose failure is described by the position and the reason.
+    template <typename StepT>
+    decltype(StepT::result) read_char_result(Reader& reader, size_t outcome) {
+        using Success = typename StepT::Success;
+        using Failure = typename StepT::Failure;
+        if (outcome == 0) {
+            return Success{.string_span = reader.read_string_span()};
+        }
+        return Failure{
+            .string_pos = reader.read_varint(),
+            .failure_reason =
+                ReasonDecoder<decltype(Failure::failure_reason)>::decode(outcome - 1),
+        };
+    }
+}  // namespace
+
+StepLog::ConstIterator::ConstIterator(const StepLog& log, size_t offset)
+    : m_log(&log), m_offset(offset), m_next_offset(offset) {
+    decode();
+}
+
+const Step& StepLog::ConstIterator::operator*() const {
+    return m_current.value();
+}
+
+const Step* StepLog::ConstIterator::operator->() const {
+    return &m_current.value();
+}
+
+StepLog::ConstIterator& StepLog::ConstIterator::operator++() {
+    m_offset = m_next_offset;
+    ++m_index;
+    decode();
+    return *this;
+}
+
+bool StepLog::ConstIterator::operator==(const ConstIterator& other) const {
+    return m_log == other.m_log && m_offset == other.m_offset;
+}
+
+void StepLog::ConstIterator::decode() {
+    if (m_offset == m_log->m_bytes.size()) {
+        m_current.reset();
+        return;
+    }
+
+    auto reader = Reader(m_log->m_bytes, m_offset);
+    auto tag = reader.read_byte();
+    auto outcome = size_t(tag >> outcome_shift);
+    auto read = [&reader]() -> size_t { return reader.read_varint(); };
+    auto read_regex_span = [this, &read]() { return m_log->m_regex_spans.at(read()); };
+    auto read_quantifier_type = [&read]() { return static_cast<QuantifierType>(read()); };
+
+    // The fields are read in the order of declaration, which is also the order of evaluation
+    // of the initializers below.
+    switch (static_cast<StepType>(tag & step_type_mask)) {
+    case StepType::MatchQuantifier:
+        m_current = step::MatchQuantifier{
+            .regex_span = read_regex_span(),
+            .string_pos = read(),
+            .quantifier_type = read_quantifier_type(),
+        };
+        break;
+    case StepType::FinishQuantifier: {
+        using FinishQuantifier = step::FinishQuantifier;
+        auto quantifier_type = read_quantifier_type();
+        auto regex_span = read_regex_span();
+        auto result = outcome == 0
+                          ? decltype(FinishQuantifier::result)(FinishQuantifier::Success{
+                              .string_span = reader.read_string_span(),
+                              .num_repetitions = read(),
+                          })
+                          : FinishQuantifier::Failure{
+                              .string_pos = read(),
+                              .failure_reason = failure_reasons::OptionsExhausted{},
+                          };
+        m_current = FinishQuantifier{
+            .quantifier_type = quantifier_type,
+            .regex_span = regex_span,
+            .result = std::move(result),
+        };
+        break;
+    }
+    case StepType::MatchCharClass:
+        m_current = step::MatchCharClass{
+            .regex_span = read_regex_span(),
+            .result = read_char_result<step::MatchCharClass>(reader, outcome),
+        };
+        break;
+    case StepType::MatchLiteral:
+        m_current = step::MatchLiteral{
+            .regex_span = read_regex_span(),
+            .literal = static_cast<char32_t>(read()),
+            .result = read_char_result<step::MatchLiteral>(reader, outcome),
+        };
+        break;
+    case StepType::MatchWildcard:
+        m_current = step::MatchWildcard{
+            .regex_span = read_regex_span(),
+            .result = read_char_result<step::MatchWildcard>(reader, outcome),
+        };
+        break;
+    case StepType::BeginGroup:
+        m_current = step::BeginGroup{
+            .regex_span = read_regex_span(),
+            .string_pos = read(),
+        };
+        break;
+    case StepType::EndGroup:
+        m_current = step::EndGroup{.string_pos = read()};
+        break;
+    case StepType::MatchAlternatives:
+        m_current = step::MatchAlternatives{
+            .regex_span = read_regex_span(),
+            .string_pos = read(),
+        };
+        break;
+    case StepType::FinishAlternatives: {
+        using FinishAlternatives = step::FinishAlternatives;
+        auto regex_span = read_regex_span();
+        auto result = outcome == 0
+                          ? decltype(FinishAlternatives::result)(FinishAlternatives::Success{
+                              .string_span = reader.read_string_span(),
+                              .alternative_chosen = read(),
+                          })
+                          : FinishAlternatives::Failure{
+                              .string_pos = read(),
+                              .failure_reason = failure_reasons::OptionsExhausted{},
+                          };
+        m_current = FinishAlternatives{
+            .regex_span = regex_span,
+            .result = std::move(result),
+        };
+        break;
+    }
+    case StepType::Backtrack:
+        m_current = step::Backtrack{
+            .string_pos = read(),
+            .continue_after_step = m_index - read(),
+        };
+        break;
+    case StepType::End:
+        m_current = step::End{
+            .string_pos = read(),
+            .result = outcome == 0 ? decltype(step::End::result)(step::End::Success{})
+                                   : step::End::Failure{},
+        };
+        break;
+    }
+    m_next_offset = reader.offset();
+}
+
+void StepLog::consume(Step step) {
+    auto& bytes = m_bytes;
+    auto write_tag = [&bytes](StepType type, uint8_t outcome) {
+        bytes.push_back(
+            static_cast<uint8_t>(type) | static_cast<uint8_t>(outcome << outcome_shift));
+    };
+    auto write = [&bytes](uint64_t value) { write_varint(bytes, value); };
+    auto write_regex_span = [this, &write](Span span) { write(regex_span_index(span)); };
+    auto write_string_span = [&write](Span span) {
+        write(span.begin());
+        write(span.length());
+    };
+    auto write_char_result = [&write, &write_string_span](const auto& result) {
+        result.visit([&write, &write_string_span](const auto& outcome) {
+            if constexpr (std::decay_t<decltype(outcome)>::success) {
+                write_string_span(outcome.string_span);
+            } else {
+                write(outcome.string_pos);
+            }
+        });
+    };
+
+    step.visit(
+        [&](const step::MatchQuantifier& step) {
+            write_tag(StepType::MatchQuantifier, 0);
+            write_regex_span(step.regex_span);
+            write(step.string_pos);
+            write(static_cast<uint64_t>(step.quantifier_type));
+        },
+        [&](const step::FinishQuantifier& step) {
+            write_tag(StepType::FinishQuantifier, outcome_of(step.result));
+            write(static_cast<uint64_t>(step.quantifier_type));
+            write_regex_span(step.regex_span);
+            step.result.visit(
+                [&](const step::FinishQuantifier::Success& success) {
+                    write_string_span(success.string_span);
+                    write(success.num_repetitions);
+                },
+                [&](const step::FinishQuantifier::Failure& failure) {
+                    write(failure.string_pos);
+                });
+        },
+        [&](const step::MatchCharClass& step) {
+            write_tag(StepType::MatchCharClass, outcome_of(step.result));
+            write_regex_span(step.regex_span);
+            write_char_result(step.result);
+        },
+        [&](const step::MatchLiteral& step) {
+            write_tag(StepType::MatchLiteral, outcome_of(step.result));
+            write_regex_span(step.regex_span);
+            write(step.literal);
+            write_char_result(step.result);
+        },
+        [&](const step::MatchWildcard& step) {
+            write_tag(StepType::MatchWildcard, outcome_of(step.result));
+            write_regex_span(step.regex_span);
+            write_char_result(step.result);
+        },
+        [&](const step::BeginGroup& step) {
+            write_tag(StepType::BeginGroup, 0);
+            write_regex_span(step.regex_span);
+            write(step.string_pos);
+        },
+        [&](const step::EndGroup& step) {
+            write_tag(StepType::EndGroup, 0);
+            write(step.string_pos);
+        },
+        [&](const step::MatchAlternatives& step) {
+            write_tag(StepType::MatchAlternatives, 0);
+            write_regex_span(step.regex_span);
+            write(step.string_pos);
+        },
+        [&](const step::FinishAlternatives& step) {
+            write_tag(StepType::FinishAlternatives, outcome_of(step.result));
+            write_regex_span(step.regex_span);
+            step.result.visit(
+                [&](const step::FinishAlternatives::Success& success) {
+                    write_string_span(success.string_span);
+                    write(success.alternative_chosen);
+                },
+                [&](const step::FinishAlternatives::Failure& failure) {
+                    write(failure.string_pos);
+                });
+        },
+        [&](const step::Backtrack& step) {
+            write_tag(StepType::Backtrack, 0);
+            write(step.string_pos);
+            // The step backtracked to usually is a recent one, so the distance is small. It is
+            // computed modulo 2^64, so that any value survives the round trip.
+            write(uint64_t(m_size) - uint64_t(step.continue_after_step));
+        },
+        [&](const step::End& step) {
+            write_tag(StepType::End, outcome_of(step.result));
+            write(step.string_pos);
+        });
+    ++m_size;
+}
+
+size_t StepLog::memory_usage() const {
+    using Entry = decltype(m_regex_span_indices)::value_type;
+    return m_bytes.capacity() + m_regex_spans.capacity() * sizeof(Span)
+        + m_regex_span_indices.bucket_count() * sizeof(void*)
+        + m_regex_span_indices.size() * (sizeof(Entry) + sizeof(void*));
+}
+
+size_t StepLog::size() const {
+    return m_size;
+}
+
+bool StepLog::empty() const {
+    return m_size == 0;
+}
+
+StepLog::ConstIterator StepLog::begin() const {
+    return ConstIterator(*this, 0);
+}
+
+StepLog::ConstIterator StepLog::end() const {
+    return ConstIterator(*this, m_bytes.size());
+}
+
+std::vector<Step> StepLog::to_steps() const {
+    auto steps = std::vector<Step>();
+    steps.reserve(m_size);
+    for (const auto& step : *this) {
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+size_t StepLog::SpanHash::operator()(const Span& span) const {
+    return std::hash<size_t>()(span.begin() * 31 + span.end());
+}
+
+uint32_t StepLog::regex_span_index(const Span& span) {
+    auto [it, inserted] =
+        m_regex_span_indices.try_emplace(span, static_cast<uint32_t>(m_regex_spans.size()));
+    if (inserted) {
+        m_regex_spans.push_back(span);
+    }
+    return it->second;
+}
+
+void to_json(nlohmann::json& j, const StepLog& log) {
+    j = nlohmann::json::array();
+    for (const auto& step : log) {
+        j.push_back(step);
+    }
+}
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,53 @@
+// wr22
+#include <wr22/regex_executor/algorithms/backtracking/step_sink.hpp>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+namespace wr22::regex_executor::algorithms::backtracking {
+
+size_t StepSink::memory_usage() const {
+    return 0;
+}
+
+void VectorStepSink::consume(Step step) {
+    m_steps.push_back(std::move(step));
+}
+
+size_t VectorStepSink::memory_usage() const {
+    return m_steps.capacity() * sizeof(Step);
+}
+
+const std::vector<Step>& VectorStepSink::steps() const {
+    return m_steps;
+}
+
+std::vector<Step> VectorStepSink::into_steps() && {
+    return std::move(m_steps);
+}
+
+void CountingStepSink::consume([[maybe_unused]] Step step) {
+    ++m_num_steps;
+}
+
+size_t CountingStepSink::num_steps() const {
+    return m_num_steps;
+}
+
+JsonStepSink::JsonStepSink(std::ostream& out) : m_out(out) {
+    m_out << '[';
+}
+
+void JsonStepSink::consume(Step step) {
+    if (!m_empty) {
+        m_out << ',';
+    }
+    m_empty = false;
+    m_out << nlohmann::json(step).dump();
+}
+
+void JsonStepSink::finish() {
+    m_out << ']';
+}
+
+}  // namespace wr22::regex_executor::algorithms::backtracking
@@ -0,0 +1,43 @@
+// wr22
+#include <wr22/regex_executor/algorithms/bit_parallel/executor.hpp>
+#include <wr22/regex_executor/algorithms/bit_parallel/position_automaton.hpp>
+
+namespace wr22::regex_executor::algorithms::bit_parallel {
+
+Executor::Executor(const Regex& regex_ref) : m_regex_ref(regex_ref) {}
+
+const Regex& Executor::regex_ref() const {
+    return m_regex_ref.get();
+}
+
+std::optional<MatchResult> Executor::execute(
+    const std::u32string_view& string,
+    Fragment fragment) const {
+    const auto& maybe_automaton = regex_ref().bit_parallel_automaton();
+    if (!maybe_automaton.has_value()) {
+        return std::nullopt;
+    }
+    const auto& automaton = maybe_automaton.value();
+    auto accepting_states = automaton.accepting_states();
+
+    auto states = PositionAutomaton::initial_state;
+    if (fragment == Fragment::Whole) {
+        for (auto c : string) {
+            states = automaton.follow(states) & automaton.mask(c);
+            if (states == 0) {
+                return MatchResult{.matched = false};
+            }
+        }
+        return MatchResult{.matched = (states & accepting_states) != 0};
+    }
+
+    for (auto c : string) {
+        if ((states & accepting_states) != 0) {
+            return MatchResult{.matched = true};
+        }
+        states = (automaton.follow(states) & automaton.mask(c)) | PositionAutomaton::initial_state;
+    }
+    return MatchResult{.matched = (states & accepting_states) != 0};
+}
+
+}  // namespace wr22::regex_executor::algorithms::bit_parallel
@@ -0,0 +1,220 @@
+// wr22
+#include <wr22/regex_executor/algorithms/bit_parallel/position_automaton.hpp>
+#include <wr22/regex_executor/program/char_class.hpp>
+
+// stl
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <limits>
+#include <set>
+
+namespace wr22::regex_executor::algorithms::bit_parallel {
+
+namespace part = regex_parser::regex::part;
+using regex_parser::regex::SpannedPart;
+
+namespace {
+    constexpr auto max_char = std::numeric_limits<char32_t>::max();
+
+    /// Call `f` with the index of every state in a set.
+    template <typename F>
+    void for_each_state(StateSet states, F&& f) {
+        while (states != 0) {
+            f(static_cast<size_t>(std::countr_zero(states)));
+            states &= states - 1;
+        }
+    }
+
+    /// Collects the positions of a regex and the `follow` sets between them.
+    class Builder {
+    public:
+        /// The Glushkov sets of a subexpression.
+        struct Info {
+            /// Whether the subexpression matches the empty string.
+            bool nullable;
+            /// The positions that can consume the first character of a match.
+            StateSet first;
+            /// The positions that can consume the last character of a match.
+            StateSet last;
+        };
+
+        /// Visit a subexpression, returning `std::nullopt` if there are too many positions.
+        std::optional<Info> visit(const SpannedPart& spanned_part) {
+            return spanned_part.part().visit(
+                []([[maybe_unused]] const part::Empty& part) -> std::optional<Info> {
+                    return Info{.nullable = true, .first = 0, .last = 0};
+                },
+                [this](const part::Literal& part) {
+                    return add_position({{.first = part.character, .last = part.character}});
+                },
+                [this]([[maybe_unused]] const part::Wildcard& part) {
+                    return add_position({{.first = 0, .last = max_char}});
+                },
+                [this](const part::CharacterClass& part) {
+                    return add_position(program::CompiledCharClass(part.data).ranges());
+                },
+                [this](const part::Alternatives& part) -> std::optional<Info> {
+                    auto info = Info{.nullable = false, .first = 0, .last = 0};
+                    for (const auto& alternative : part.alternatives) {
+                        auto alternative_info = visit(alternative);
+                        if (!alternative_info.has_value()) {
+                            return std::nullopt;
+                        }
+                        info.nullable = info.nullable || alternative_info->nullable;
+                        info.first |= alternative_info->first;
+                        info.last |= alternative_info->last;
+                    }
+                    return info;
+                },
+                [this](const part::Sequence& part) -> std::optional<Info> {
+                    auto info = Info{.nullable = true, .first = 0, .last = 0};
+                    for (const auto& item : part.items) {
+                        auto item_info = visit(item);
+                        if (!item_info.has_value()) {
+                            return std::nullopt;
+                        }
+                        add_follow(info.last, item_info->first);
+                        if (info.nullable) {
+                            info.first |= item_info->first;
+                        }
+                        info.last = item_info->nullable ? info.last | item_info->last
+                                                        : item_info->last;
+                        info.nullable = info.nullable && item_info->nullable;
+                    }
+                    return info;
+                },
+                [this](const part::Group& part) { return visit(*part.inner); },
+                [this](const part::Optional& part) -> std::optional<Info> {
+                    auto info = visit(*part.inner);
+                    if (info.has_value()) {
+                        info->nullable = true;
+                    }
+                    return info;
+                },
+                [this](const part::Star& part) -> std::optional<Info> {
+                    auto info = visit(*part.inner);
+                    if (info.has_value()) {
+                        add_follow(info->last, info->first);
+                        info->nullable = true;
+                    }
+                    return info;
+                },
+                [this](const part::Plus& part) -> std::optional<Info> {
+                    auto info = visit(*part.inner);
+                    if (info.has_value()) {
+                        add_follow(info->last, info->first);
+                    }
+                    return info;
+                });
+        }
+
+        /// Let the states `to` follow each of the states `from`.
+        void add_follow(StateSet from, StateSet to) {
+            for_each_state(from, [this, to](size_t state) { follow[state] |= to; });
+        }
+
+        /// `follow` of every state, indexed by the state's bit.
+        std::array<StateSet, PositionAutomaton::max_positions + 1> follow = {};
+        /// The characters consumed by each position, as sorted disjoint ranges. Index 0 stands
+        /// for the initial state and is empty.
+        std::vector<std::vector<program::CompiledCharClass::Range>> position_ranges{{}};
+
+    private:
+        std::optional<Info> add_position(std::vector<program::CompiledCharClass::Range> ranges) {
+            if (position_ranges.size() > PositionAutomaton::max_positions) {
+                return std::nullopt;
+            }
+            auto bit = StateSet(1) << position_ranges.size();
+            position_ranges.push_back(std::move(ranges));
+            return Info{.nullable = false, .first = bit, .last = bit};
+        }
+    };
+}  // namespace
+
+std::optional<PositionAutomaton> PositionAutomaton::build(const SpannedPart& root_part) {
+    auto builder = Builder();
+    auto root_info = builder.visit(root_part);
+    if (!root_info.has_value()) {
+        return std::nullopt;
+    }
+    builder.follow[0] = root_info->first;
+
+    auto automaton = PositionAutomaton();
+    automaton.m_accepting_states = root_info->last | (root_info->nullable ? initial_state : 0);
+
+    auto num_states = builder.position_ranges.size();
+    auto num_tables = (num_states + 7) / 8;
+    automaton.m_follow_tables.resize(num_tables);
+    for (size_t table = 0; table < num_tables; ++table) {
+        for (size_t byte = 0; byte < 256; ++byte) {
+            auto states = StateSet(byte) << (8 * table);
+            for_each_state(states, [&](size_t state) {
+                automaton.m_follow_tables[table][byte] |= builder.follow[state];
+            });
+        }
+    }
+
+    // Split the characters into ranges no position range boundary crosses.
+    auto range_starts = std::set<char32_t>{0};
+    for (const auto& ranges : builder.position_ranges) {
+        for (const auto& range : ranges) {
+            range_starts.insert(range.first);
+            if (range.last != max_char) {
+                range_starts.insert(range.last + 1);
+            }
+        }
+    }
+    for (auto first : range_starts) {
+        automaton.m_char_ranges.push_back(CharRange{.first = first, .mask = 0});
+    }
+    for (size_t position = 1; position < num_states; ++position) {
+        for (const auto& range : builder.position_ranges[position]) {
+            auto begin = std::lower_bound(
+                automaton.m_char_ranges.begin(),
+                automaton.m_char_ranges.end(),
+                range.first,
+                [](const CharRange& char_range, char32_t c) { return char_range.first < c; });
+            for (auto it = begin; it != automaton.m_char_ranges.end() && it->first <= range.last;
+                 ++it) {
+                it->mask |= StateSet(1) << position;
+            }
+        }
+    }
+    for (char32_t c = 0; c < automaton.m_ascii_masks.size(); ++c) {
+        automaton.m_ascii_masks[c] = automaton.range_mask(c);
+    }
+    return automaton;
+}
+
+StateSet PositionAutomaton::follow(StateSet states) const {
+    auto result = StateSet(0);
+    for (const auto& table : m_follow_tables) {
+        result |= table[states & 0xff];
+        states >>= 8;
+    }
+    return result;
+}
+
+StateSet PositionAutomaton::mask(char32_t c) const {
+    if (c < m_ascii_masks.size()) {
+        return m_ascii_masks[c];
+    }
+    return range_mask(c);
+}
+
+StateSet PositionAutomaton::range_mask(char32_t c) const {
+    // Find the last range that starts at or before `c`.
+    auto it = std::upper_bound(
+        m_char_ranges.begin(),
+        m_char_ranges.end(),
+        c,
+        [](char32_t c, const CharRange& char_range) { return c < char_range.first; });
+    return std::prev(it)->mask;
+}
+
+StateSet PositionAutomaton::accepting_states() const {
+    return m_accepting_states;
+}
+
+}  // namespace wr22::regex_executor::algorithms::bit_parallel
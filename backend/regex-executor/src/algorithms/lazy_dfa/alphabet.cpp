@@ -0,0 +1,70 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/alphabet.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+
+// stl
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <set>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+namespace instruction = program::instruction;
+
+namespace {
+    /// Mark `[first, last]` as a range no class boundary may cross.
+    void add_range(std::set<char32_t>& class_starts, char32_t first, char32_t last) {
+        class_starts.insert(first);
+        if (last != std::numeric_limits<char32_t>::max()) {
+            class_starts.insert(last + 1);
+        }
+    }
+}  // namespace
+
+Alphabet::Alphabet(const program::Program& program)
+    : Alphabet(std::span<const program::Program* const>(std::array{&program})) {}
+
+Alphabet::Alphabet(std::span<const program::Program* const> programs) {
+    auto class_starts = std::set<char32_t>{0};
+    for (const auto* program : programs) {
+        for (const auto& instruction : program->instructions) {
+            instruction.visit(
+                [&class_starts](const instruction::Literal& instruction) {
+                    add_range(class_starts, instruction.character, instruction.character);
+                },
+                [&class_starts, program](const instruction::CharClass& instruction) {
+                    const auto& char_class = program->char_classes.at(instruction.class_index);
+                    for (const auto& range : char_class.ranges()) {
+                        add_range(class_starts, range.first, range.last);
+                    }
+                },
+                []([[maybe_unused]] const auto& instruction) {});
+        }
+    }
+    m_class_starts.assign(class_starts.begin(), class_starts.end());
+
+    // `class_of` falls back to this for non-ASCII characters.
+    for (char32_t c = 0; c < m_ascii_classes.size(); ++c) {
+        auto it = std::upper_bound(m_class_starts.begin(), m_class_starts.end(), c);
+        m_ascii_classes[c] = static_cast<size_t>(it - m_class_starts.begin()) - 1;
+    }
+}
+
+size_t Alphabet::num_classes() const {
+    return m_class_starts.size();
+}
+
+size_t Alphabet::class_of(char32_t c) const {
+    if (c < m_ascii_classes.size()) {
+        return m_ascii_classes[c];
+    }
+    auto it = std::upper_bound(m_class_starts.begin(), m_class_starts.end(), c);
+    return static_cast<size_t>(it - m_class_starts.begin()) - 1;
+}
+
+char32_t Alphabet::representative(size_t class_index) const {
+    return m_class_starts.at(class_index);
+}
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
@@ -0,0 +1,280 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/executor.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <algorithm>
+#include <utility>
+#include <variant>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+namespace instruction = program::instruction;
+
+namespace {
+    /// The cache is considered to be thrashing if it has been cleared at least this many times
+    /// and ...
+    constexpr size_t min_clears_to_give_up = 3;
+    /// ... fewer than this many characters per state have been processed since the last clear.
+    constexpr size_t min_chars_per_state = 10;
+}  // namespace
+
+Executor::Executor(const Regex& regex_ref, Fragment fragment, size_t cache_capacity)
+    : m_regex_ref(regex_ref), m_searching(fragment == Fragment::Search),
+      m_alphabet(regex_ref.program()),
+      m_cache(m_alphabet.num_classes(), cache_capacity),
+      m_closure_set(regex_ref.program().instructions.size()) {
+    const auto& program = regex_ref.program();
+    m_start_pcs = closure_of({0});
+    for (size_t pc = 0; pc < program.instructions.size(); ++pc) {
+        if (program::epsilon_successors(program, pc).empty()) {
+            m_all_pcs.push_back(pc);
+        }
+    }
+}
+
+const Regex& Executor::regex_ref() const {
+    return m_regex_ref.get();
+}
+
+std::optional<MatchResult> Executor::execute(const std::u32string_view& string) {
+    auto state = start_state();
+    if (!state.has_value()) {
+        if (!clear_cache()) {
+            return std::nullopt;
+        }
+        state = start_state();
+        if (!state.has_value()) {
+            return std::nullopt;
+        }
+    }
+
+    for (size_t cursor = 0; cursor < string.size(); ++cursor) {
+        if (m_searching) {
+            if (m_cache.accepting(state.value())) {
+                return MatchResult{.matched = true};
+            }
+            if (state == m_start_state) {
+                // No attempt to match is in progress: skip the positions no match can start at.
+                const auto& regex = regex_ref();
+                auto candidate =
+                    regex.start_filter().next_candidate(regex.program(), string, cursor);
+                if (!candidate.has_value()) {
+                    return MatchResult{.matched = false};
+                }
+                cursor = candidate.value();
+            }
+        }
+
+        state = step(state.value(), m_alphabet.class_of(string[cursor]));
+        if (!state.has_value()) {
+            return std::nullopt;
+        }
+        if (state.value() == StateCache::dead_state) {
+            return MatchResult{.matched = false};
+        }
+    }
+    return MatchResult{.matched = m_cache.accepting(state.value())};
+}
+
+std::optional<ChunkRun> Executor::run_chunk(
+    const std::u32string_view& chunk,
+    const std::vector<size_t>& start_pcs,
+    size_t checkpoint_interval,
+    const std::vector<std::vector<size_t>>* expected_checkpoints) {
+    auto state = state_or_clear(start_pcs);
+    if (!state.has_value()) {
+        return std::nullopt;
+    }
+
+    auto run = ChunkRun();
+    for (size_t cursor = 0; cursor < chunk.size(); ++cursor) {
+        if (m_searching && m_cache.accepting(state.value())) {
+            run.accepted = true;
+            break;
+        }
+        state = step(state.value(), m_alphabet.class_of(chunk[cursor]));
+        if (!state.has_value()) {
+            return std::nullopt;
+        }
+        if ((cursor + 1) % checkpoint_interval == 0) {
+            const auto& pcs = m_cache.pcs_of(state.value());
+            auto checkpoint_index = (cursor + 1) / checkpoint_interval - 1;
+            if (expected_checkpoints == nullptr) {
+                run.checkpoints.push_back(pcs);
+            } else if (
+                checkpoint_index < expected_checkpoints->size()
+                && (*expected_checkpoints)[checkpoint_index] == pcs) {
+                run.converged_at = checkpoint_index;
+                break;
+            }
+        }
+        if (state.value() == StateCache::dead_state) {
+            // The dead state is never left.
+            break;
+        }
+    }
+    if (m_searching && m_cache.accepting(state.value())) {
+        run.accepted = true;
+    }
+    run.end_pcs = m_cache.pcs_of(state.value());
+    return run;
+}
+
+const std::vector<size_t>& Executor::start_pcs() const {
+    return m_start_pcs;
+}
+
+const std::vector<size_t>& Executor::all_pcs() const {
+    return m_all_pcs;
+}
+
+bool Executor::accepting(const std::vector<size_t>& pcs) const {
+    const auto& instructions = regex_ref().program().instructions;
+    return std::any_of(pcs.begin(), pcs.end(), [&instructions](size_t pc) {
+        return std::holds_alternative<instruction::Match>(instructions.at(pc).as_variant());
+    });
+}
+
+std::optional<StateId> Executor::state_for(const std::vector<size_t>& pcs) {
+    auto closure = closure_of(pcs);
+    if (auto state = m_cache.find(closure); state.has_value()) {
+        return state;
+    }
+    if (!m_cache.can_fit(closure.size())) {
+        return std::nullopt;
+    }
+    auto is_accepting = accepting(closure);
+    return m_cache.insert(std::move(closure), is_accepting);
+}
+
+std::vector<size_t> Executor::closure_of(const std::vector<size_t>& pcs) {
+    const auto& program = regex_ref().program();
+
+    // Follow the epsilon transitions, keeping only the instructions that wait for input.
+    auto closure = std::vector<size_t>();
+    m_closure_set.clear();
+    m_closure_stack.assign(pcs.begin(), pcs.end());
+    while (!m_closure_stack.empty()) {
+        auto pc = m_closure_stack.back();
+        m_closure_stack.pop_back();
+        if (!m_closure_set.insert(pc)) {
+            continue;
+        }
+        program.instructions.at(pc).visit(
+            [this](const instruction::Alternatives& instruction) {
+                m_closure_stack.insert(
+                    m_closure_stack.end(),
+                    instruction.targets.begin(),
+                    instruction.targets.end());
+            },
+            [this](const instruction::FinishAlternative& instruction) {
+                m_closure_stack.push_back(instruction.target);
+            },
+            [this, pc]([[maybe_unused]] const instruction::BeginGroup& instruction) {
+                m_closure_stack.push_back(pc + 1);
+            },
+            [this, pc]([[maybe_unused]] const instruction::EndGroup& instruction) {
+                m_closure_stack.push_back(pc + 1);
+            },
+            [this, pc]([[maybe_unused]] const instruction::BeginQuantifier& instruction) {
+                m_closure_stack.push_back(pc + 1);
+            },
+            [this](const instruction::QuantifierSplit& instruction) {
+                m_closure_stack.push_back(instruction.body);
+                m_closure_stack.push_back(instruction.exit);
+            },
+            [this](const instruction::EndIteration& instruction) {
+                m_closure_stack.push_back(instruction.target);
+            },
+            [this, pc]([[maybe_unused]] const instruction::EndQuantifier& instruction) {
+                m_closure_stack.push_back(pc + 1);
+            },
+            [&closure, pc]([[maybe_unused]] const auto& instruction) {
+                // A character-consuming instruction or `Match`.
+                closure.push_back(pc);
+            });
+    }
+    std::sort(closure.begin(), closure.end());
+    return closure;
+}
+
+std::optional<StateId> Executor::state_or_clear(const std::vector<size_t>& pcs) {
+    if (auto state = state_for(pcs); state.has_value()) {
+        return state;
+    }
+    if (!clear_cache()) {
+        return std::nullopt;
+    }
+    return state_for(pcs);
+}
+
+std::optional<StateId> Executor::step(StateId from, size_t class_index) {
+    auto next = next_state(from, class_index);
+    if (!next.has_value()) {
+        // The cache is full. Clear it, but keep the current state.
+        auto pcs = m_cache.pcs_of(from);
+        auto is_accepting = m_cache.accepting(from);
+        if (!clear_cache()) {
+            return std::nullopt;
+        }
+        auto state = m_cache.find(pcs);
+        if (!state.has_value()) {
+            state = m_cache.insert(std::move(pcs), is_accepting);
+        }
+        next = next_state(state.value(), class_index);
+        if (!next.has_value()) {
+            return std::nullopt;
+        }
+    }
+    ++m_chars_since_clear;
+    return next;
+}
+
+std::optional<StateId> Executor::start_state() {
+    if (!m_start_state.has_value()) {
+        m_start_state = state_for({0});
+    }
+    return m_start_state;
+}
+
+std::optional<StateId> Executor::next_state(StateId from, size_t class_index) {
+    if (auto cached = m_cache.transition(from, class_index); cached != StateCache::unknown_state) {
+        return cached;
+    }
+
+    // All the characters of a class are consumed by the same instructions, so it is enough to
+    // check one of them.
+    const auto& program = regex_ref().program();
+    auto c = m_alphabet.representative(class_index);
+    auto successors = std::vector<size_t>();
+    if (m_searching) {
+        // A new attempt to match may start at every position.
+        successors.push_back(0);
+    }
+    for (auto pc : m_cache.pcs_of(from)) {
+        if (program::consumes(program, pc, c)) {
+            successors.push_back(pc + 1);
+        }
+    }
+
+    auto to = state_for(successors);
+    if (to.has_value()) {
+        m_cache.set_transition(from, class_index, to.value());
+    }
+    return to;
+}
+
+bool Executor::clear_cache() {
+    if (m_cache.num_clears() >= min_clears_to_give_up
+        && m_chars_since_clear < min_chars_per_state * m_cache.num_states()) {
+        return false;
+    }
+    m_cache.clear();
+    m_start_state = std::nullopt;
+    m_chars_since_clear = 0;
+    return true;
+}
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
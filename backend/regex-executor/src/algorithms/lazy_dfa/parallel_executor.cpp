@@ -0,0 +1,138 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/parallel_executor.hpp>
+#include <wr22/regex_executor/utils/thread_pool.hpp>
+
+// stl
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+ParallelExecutor::ParallelExecutor(
+    const Regex& regex_ref,
+    Fragment fragment,
+    size_t min_chunk_length,
+    size_t checkpoint_interval)
+    : m_regex_ref(regex_ref), m_fragment(fragment), m_min_chunk_length(min_chunk_length),
+      m_checkpoint_interval(checkpoint_interval) {}
+
+const Regex& ParallelExecutor::regex_ref() const {
+    return m_regex_ref.get();
+}
+
+std::optional<MatchResult> ParallelExecutor::execute(
+    const std::u32string_view& string,
+    size_t num_threads) {
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    auto num_chunks = std::min(num_threads, string.size() / m_min_chunk_length);
+    if (num_chunks < 2) {
+        return executor_at(0).execute(string);
+    }
+
+    auto chunks = std::vector<std::u32string_view>();
+    for (size_t i = 0; i < num_chunks; ++i) {
+        auto begin = string.size() * i / num_chunks;
+        auto end = string.size() * (i + 1) / num_chunks;
+        chunks.push_back(string.substr(begin, end - begin));
+    }
+    for (size_t i = 0; i < num_chunks; ++i) {
+        executor_at(i);
+    }
+
+    // Run every chunk but the first from a speculated state.
+    auto speculated_pcs = std::vector<std::vector<size_t>>(num_chunks);
+    auto runs = std::vector<std::optional<ChunkRun>>(num_chunks);
+    auto errors = std::vector<std::exception_ptr>(num_chunks);
+    auto run_chunk = [&](size_t i) {
+        try {
+            auto& executor = *m_executors[i];
+            if (i == 0) {
+                runs[0] =
+                    executor.run_chunk(chunks[0], executor.start_pcs(), m_checkpoint_interval);
+                return;
+            }
+            if (m_fragment == Fragment::Search) {
+                speculated_pcs[i] = executor.start_pcs();
+            } else {
+                auto begin = static_cast<size_t>(chunks[i].data() - string.data());
+                auto warm_up_begin = begin - std::min(begin, warm_up_length);
+                auto warm_up = executor.run_chunk(
+                    string.substr(warm_up_begin, begin - warm_up_begin),
+                    executor.all_pcs(),
+                    m_checkpoint_interval);
+                if (!warm_up.has_value()) {
+                    return;
+                }
+                speculated_pcs[i] = std::move(warm_up.value().end_pcs);
+            }
+            runs[i] = executor.run_chunk(chunks[i], speculated_pcs[i], m_checkpoint_interval);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    // The chunks are handed out in order to the calling thread and the threads of the shared
+    // pool, so that the calling thread alone gets through them if the pool is busy.
+    auto next_chunk = std::atomic<size_t>(0);
+    auto work = [&]([[maybe_unused]] size_t worker_index) {
+        while (true) {
+            auto i = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if (i >= num_chunks) {
+                return;
+            }
+            run_chunk(i);
+        }
+    };
+    utils::ThreadPool::shared().run(num_chunks - 1, work);
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    if (std::any_of(runs.begin(), runs.end(), [](const auto& run) { return !run.has_value(); })) {
+        return std::nullopt;
+    }
+    if (std::any_of(runs.begin(), runs.end(), [](const auto& run) { return run->accepted; })) {
+        // Only happens when searching, and the speculated states are contained in the actual
+        // ones then.
+        return MatchResult{.matched = true};
+    }
+
+    // Compose the runs, correcting the ones that have been speculated wrong.
+    auto& executor = *m_executors[0];
+    auto pcs = std::move(runs[0]->end_pcs);
+    for (size_t i = 1; i < num_chunks; ++i) {
+        if (pcs.empty()) {
+            // The dead state.
+            return MatchResult{.matched = false};
+        }
+        const auto& run = runs[i].value();
+        if (pcs == speculated_pcs[i]) {
+            pcs = run.end_pcs;
+            continue;
+        }
+        auto rerun = executor.run_chunk(chunks[i], pcs, m_checkpoint_interval, &run.checkpoints);
+        if (!rerun.has_value()) {
+            return std::nullopt;
+        }
+        if (rerun.value().accepted) {
+            return MatchResult{.matched = true};
+        }
+        pcs = rerun.value().converged_at.has_value() ? run.end_pcs
+                                                     : std::move(rerun.value().end_pcs);
+    }
+    return MatchResult{.matched = executor.accepting(pcs)};
+}
+
+Executor& ParallelExecutor::executor_at(size_t index) {
+    while (m_executors.size() <= index) {
+        m_executors.push_back(std::make_unique<Executor>(regex_ref(), m_fragment));
+    }
+    return *m_executors[index];
+}
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
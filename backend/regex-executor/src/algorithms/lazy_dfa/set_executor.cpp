@@ -0,0 +1,209 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/set_executor.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+
+// stl
+#include <algorithm>
+#include <utility>
+#include <variant>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+namespace instruction = program::instruction;
+
+namespace {
+    /// The cache is considered to be thrashing if it has been cleared at least this many times
+    /// and fewer than `min_chars_per_state` characters per state have been processed since the
+    /// last clear. The same thresholds as for `Executor`.
+    constexpr size_t min_clears_to_give_up = 3;
+    constexpr size_t min_chars_per_state = 10;
+}  // namespace
+
+SetExecutor::SetExecutor(const RegexSet& regex_set_ref, Fragment fragment, size_t cache_capacity)
+    : m_regex_set_ref(regex_set_ref), m_searching(fragment != Fragment::Whole),
+      m_cache(regex_set_ref.alphabet().num_classes(), cache_capacity),
+      m_state_matches(1), m_closure_set(regex_set_ref.num_instructions()) {
+    for (size_t regex_index = 0; regex_index < regex_set_ref.size(); ++regex_index) {
+        m_start_pcs.push_back(regex_set_ref.program_offset(regex_index));
+    }
+}
+
+const RegexSet& SetExecutor::regex_set_ref() const {
+    return m_regex_set_ref.get();
+}
+
+std::optional<SetMatchResult> SetExecutor::execute(const std::u32string_view& string) {
+    auto state = start_state();
+    if (!state.has_value()) {
+        if (!clear_cache()) {
+            return std::nullopt;
+        }
+        state = start_state();
+        if (!state.has_value()) {
+            return std::nullopt;
+        }
+    }
+
+    const auto& alphabet = regex_set_ref().alphabet();
+    auto is_matched = std::vector<bool>(regex_set_ref().size());
+    auto num_matched = size_t{0};
+    auto collect_matches = [this, &is_matched, &num_matched](StateId state) {
+        for (auto regex_index : m_state_matches[state]) {
+            if (!is_matched[regex_index]) {
+                is_matched[regex_index] = true;
+                ++num_matched;
+            }
+        }
+    };
+
+    for (size_t cursor = 0; cursor < string.size(); ++cursor) {
+        if (m_searching) {
+            collect_matches(state.value());
+            if (num_matched == is_matched.size()) {
+                break;
+            }
+        }
+
+        auto class_index = alphabet.class_of(string[cursor]);
+        auto next = next_state(state.value(), class_index);
+        if (!next.has_value()) {
+            // The cache is full. Clear it, but keep the current state.
+            auto pcs = m_cache.pcs_of(state.value());
+            if (!clear_cache()) {
+                return std::nullopt;
+            }
+            if (auto existing = m_cache.find(pcs); existing.has_value()) {
+                state = existing;
+            } else {
+                state = insert_state(std::move(pcs));
+            }
+            next = next_state(state.value(), class_index);
+            if (!next.has_value()) {
+                return std::nullopt;
+            }
+        }
+
+        state = next;
+        ++m_chars_since_clear;
+        if (state.value() == StateCache::dead_state) {
+            // Only happens when matching whole strings: no regex can match anymore.
+            return SetMatchResult{};
+        }
+    }
+    collect_matches(state.value());
+
+    auto result = SetMatchResult();
+    for (size_t regex_index = 0; regex_index < is_matched.size(); ++regex_index) {
+        if (is_matched[regex_index]) {
+            result.matched.push_back(regex_index);
+        }
+    }
+    return result;
+}
+
+std::optional<StateId> SetExecutor::state_for(const std::vector<size_t>& pcs) {
+    const auto& regex_set = regex_set_ref();
+
+    // Follow the epsilon transitions, keeping only the instructions that wait for input.
+    auto closure = std::vector<size_t>();
+    m_closure_set.clear();
+    m_closure_stack.assign(pcs.begin(), pcs.end());
+    while (!m_closure_stack.empty()) {
+        auto pc = m_closure_stack.back();
+        m_closure_stack.pop_back();
+        if (!m_closure_set.insert(pc)) {
+            continue;
+        }
+        auto regex_index = regex_set.regex_index_of(pc);
+        auto offset = regex_set.program_offset(regex_index);
+        const auto& program = regex_set.regex_at(regex_index).program();
+        auto successors = program::epsilon_successors(program, pc - offset);
+        if (successors.empty()) {
+            // A character-consuming instruction or `Match`.
+            closure.push_back(pc);
+        }
+        for (auto successor : successors) {
+            m_closure_stack.push_back(offset + successor);
+        }
+    }
+    std::sort(closure.begin(), closure.end());
+
+    if (auto state = m_cache.find(closure); state.has_value()) {
+        return state;
+    }
+    if (!m_cache.can_fit(closure.size())) {
+        return std::nullopt;
+    }
+    return insert_state(std::move(closure));
+}
+
+StateId SetExecutor::insert_state(std::vector<size_t> pcs) {
+    const auto& regex_set = regex_set_ref();
+    auto matches = std::vector<size_t>();
+    for (auto pc : pcs) {
+        auto regex_index = regex_set.regex_index_of(pc);
+        auto offset = regex_set.program_offset(regex_index);
+        const auto& program = regex_set.regex_at(regex_index).program();
+        if (std::holds_alternative<instruction::Match>(
+                program.instructions.at(pc - offset).as_variant())) {
+            // Each program has a single `Match`, and `pcs` are sorted, so the indices are too.
+            matches.push_back(regex_index);
+        }
+    }
+    auto accepting = !matches.empty();
+    auto state = m_cache.insert(std::move(pcs), accepting);
+    m_state_matches.push_back(std::move(matches));
+    return state;
+}
+
+std::optional<StateId> SetExecutor::start_state() {
+    if (!m_start_state.has_value()) {
+        m_start_state = state_for(m_start_pcs);
+    }
+    return m_start_state;
+}
+
+std::optional<StateId> SetExecutor::next_state(StateId from, size_t class_index) {
+    if (auto cached = m_cache.transition(from, class_index); cached != StateCache::unknown_state) {
+        return cached;
+    }
+
+    // All the characters of a class are consumed by the same instructions, so it is enough to
+    // check one of them.
+    const auto& regex_set = regex_set_ref();
+    auto c = regex_set.alphabet().representative(class_index);
+    auto successors = std::vector<size_t>();
+    if (m_searching) {
+        // A new attempt to match each regex may start at every position.
+        successors = m_start_pcs;
+    }
+    for (auto pc : m_cache.pcs_of(from)) {
+        auto regex_index = regex_set.regex_index_of(pc);
+        auto offset = regex_set.program_offset(regex_index);
+        if (program::consumes(regex_set.regex_at(regex_index).program(), pc - offset, c)) {
+            successors.push_back(pc + 1);
+        }
+    }
+
+    auto to = state_for(successors);
+    if (to.has_value()) {
+        m_cache.set_transition(from, class_index, to.value());
+    }
+    return to;
+}
+
+bool SetExecutor::clear_cache() {
+    if (m_cache.num_clears() >= min_clears_to_give_up
+        && m_chars_since_clear < min_chars_per_state * m_cache.num_states()) {
+        return false;
+    }
+    m_cache.clear();
+    // Only the dead state is left, and it accepts nothing.
+    m_state_matches.resize(1);
+    m_start_state = std::nullopt;
+    m_chars_since_clear = 0;
+    return true;
+}
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
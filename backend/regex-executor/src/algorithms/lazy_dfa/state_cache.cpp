@@ -0,0 +1,75 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/state_cache.hpp>
+
+namespace wr22::regex_executor::algorithms::lazy_dfa {
+
+StateCache::StateCache(size_t num_classes, size_t capacity)
+    : m_num_classes(num_classes), m_capacity(capacity) {
+    clear();
+    m_num_clears = 0;
+}
+
+std::optional<StateId> StateCache::find(const std::vector<size_t>& pcs) const {
+    if (auto it = m_ids.find(pcs); it != m_ids.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+bool StateCache::can_fit(size_t num_pcs) const {
+    return m_memory_usage + state_size(num_pcs) <= m_capacity
+           && m_states.size() < unknown_state;
+}
+
+StateId StateCache::insert(std::vector<size_t> pcs, bool accepting) {
+    auto id = static_cast<StateId>(m_states.size());
+    m_memory_usage += state_size(pcs.size());
+    m_ids.emplace(pcs, id);
+    m_states.push_back(State{.pcs = std::move(pcs), .accepting = accepting});
+    m_transitions.resize(m_transitions.size() + m_num_classes, unknown_state);
+    return id;
+}
+
+const std::vector<size_t>& StateCache::pcs_of(StateId state) const {
+    return m_states.at(state).pcs;
+}
+
+bool StateCache::accepting(StateId state) const {
+    return m_states.at(state).accepting;
+}
+
+StateId StateCache::transition(StateId from, size_t class_index) const {
+    return m_transitions[from * m_num_classes + class_index];
+}
+
+void StateCache::set_transition(StateId from, size_t class_index, StateId to) {
+    m_transitions[from * m_num_classes + class_index] = to;
+}
+
+void StateCache::clear() {
+    m_states.clear();
+    m_ids.clear();
+    m_transitions.clear();
+    m_memory_usage = 0;
+    ++m_num_clears;
+
+    auto dead = insert({}, false);
+    for (size_t i = 0; i < m_num_classes; ++i) {
+        set_transition(dead, i, dead);
+    }
+}
+
+size_t StateCache::num_states() const {
+    return m_states.size();
+}
+
+size_t StateCache::num_clears() const {
+    return m_num_clears;
+}
+
+size_t StateCache::state_size(size_t num_pcs) const {
+    // The program counters are stored twice: in the state itself and in the key of `m_ids`.
+    return sizeof(State) + 2 * num_pcs * sizeof(size_t) + m_num_classes * sizeof(StateId);
+}
+
+}  // namespace wr22::regex_executor::algorithms::lazy_dfa
@@ -0,0 +1,189 @@
+// wr22
+#include <wr22/regex_executor/algorithms/one_pass/automaton.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/slot_layout.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/sparse_set.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+
+// stl
+#include <map>
+#include <variant>
+
+namespace wr22::regex_executor::algorithms::one_pass {
+
+namespace instruction = program::instruction;
+using pike_vm::SlotLayout;
+
+namespace {
+    /// A consuming instruction or `Match` reachable through epsilon transitions, along with
+    /// the slot actions on the path to it.
+    struct Reached {
+        size_t pc;
+        std::vector<SlotAction> actions;
+    };
+
+    /// Follow the epsilon transitions from `pc` in the order of priority, as the Pike VM does.
+    /// An instruction reached again through a path of lower priority is not explored again.
+    std::vector<Reached> closure(
+        const program::Program& program,
+        const SlotLayout& slot_layout,
+        pike_vm::SparseSet& visited,
+        size_t start_pc) {
+        struct Frame {
+            size_t pc;
+            /// The length of the path when the branch has been deferred.
+            size_t path_length;
+        };
+
+        auto reached = std::vector<Reached>();
+        auto path = std::vector<SlotAction>();
+        auto stack = std::vector<Frame>{Frame{.pc = start_pc, .path_length = 0}};
+        visited.clear();
+        while (!stack.empty()) {
+            auto frame = stack.back();
+            stack.pop_back();
+            path.resize(frame.path_length);
+
+            auto pc = frame.pc;
+            while (visited.insert(pc)) {
+                const auto& variant = program.instructions[pc].as_variant();
+                if (const auto* begin_group = std::get_if<instruction::BeginGroup>(&variant)) {
+                    auto group = slot_layout.group_of_register(begin_group->position_register);
+                    if (group.has_value()) {
+                        path.push_back(SlotAction{.slot = slot_layout.entry_slot(group.value())});
+                    }
+                } else if (const auto* end_group = std::get_if<instruction::EndGroup>(&variant)) {
+                    if (end_group->capture_slot.has_value()) {
+                        auto group = slot_layout.group_of_register(end_group->position_register);
+                        auto capture_slot = end_group->capture_slot.value();
+                        path.push_back(SlotAction{
+                            .slot = SlotLayout::begin_slot(capture_slot),
+                            .source_slot = slot_layout.entry_slot(group.value()),
+                        });
+                        path.push_back(SlotAction{.slot = SlotLayout::end_slot(capture_slot)});
+                    }
+                }
+
+                auto successors = program::epsilon_successors(program, pc);
+                if (successors.empty()) {
+                    reached.push_back(Reached{.pc = pc, .actions = path});
+                    break;
+                }
+                for (auto it = successors.rbegin(); it + 1 != successors.rend(); ++it) {
+                    stack.push_back(Frame{.pc = *it, .path_length = path.size()});
+                }
+                pc = successors.front();
+            }
+        }
+        return reached;
+    }
+}  // namespace
+
+Automaton::Automaton(const program::Program& program) : m_alphabet(program) {}
+
+std::optional<Automaton> Automaton::build(const program::Program& program) {
+    if (program::has_empty_unbounded_iteration(program)) {
+        return std::nullopt;
+    }
+
+    auto automaton = Automaton(program);
+    auto num_classes = automaton.m_alphabet.num_classes();
+    auto slot_layout = SlotLayout(program);
+    auto visited = pike_vm::SparseSet(program.instructions.size());
+
+    // States are identified by the location they resume the program at.
+    auto state_ids = std::map<size_t, StateId>();
+    auto state_pcs = std::vector<size_t>();
+    auto state_for = [&](size_t pc) -> std::optional<StateId> {
+        if (auto it = state_ids.find(pc); it != state_ids.end()) {
+            return it->second;
+        }
+        if ((state_pcs.size() + 1) * num_classes > max_transitions) {
+            return std::nullopt;
+        }
+        auto id = static_cast<StateId>(state_pcs.size());
+        state_ids.emplace(pc, id);
+        state_pcs.push_back(pc);
+        return id;
+    };
+    auto add_actions = [&automaton](const std::vector<SlotAction>& actions, StateId to) {
+        auto begin = static_cast<uint32_t>(automaton.m_actions.size());
+        automaton.m_actions.insert(automaton.m_actions.end(), actions.begin(), actions.end());
+        return Transition{
+            .to = to,
+            .actions_begin = begin,
+            .actions_end = static_cast<uint32_t>(automaton.m_actions.size()),
+        };
+    };
+
+    state_for(0);
+    for (StateId state = 0; state < state_pcs.size(); ++state) {
+        auto reached = closure(program, slot_layout, visited, state_pcs[state]);
+
+        auto dead = Transition{.to = dead_state, .actions_begin = 0, .actions_end = 0};
+        auto accept = dead;
+        // For each class, the index of the reached instruction that consumes it.
+        auto targets = std::vector<std::optional<size_t>>(num_classes);
+        for (size_t i = 0; i < reached.size(); ++i) {
+            auto pc = reached[i].pc;
+            if (std::holds_alternative<instruction::Match>(program.instructions[pc].as_variant())) {
+                accept = add_actions(reached[i].actions, state);
+                continue;
+            }
+            for (size_t class_index = 0; class_index < num_classes; ++class_index) {
+                auto c = automaton.m_alphabet.representative(class_index);
+                if (!program::consumes(program, pc, c)) {
+                    continue;
+                }
+                if (targets[class_index].has_value()) {
+                    // Two threads can consume the same character.
+                    return std::nullopt;
+                }
+                targets[class_index] = i;
+            }
+        }
+
+        auto transitions = std::vector<Transition>(num_classes, dead);
+        auto target_transitions = std::vector<std::optional<Transition>>(reached.size());
+        for (size_t class_index = 0; class_index < num_classes; ++class_index) {
+            if (!targets[class_index].has_value()) {
+                continue;
+            }
+            auto i = targets[class_index].value();
+            if (!target_transitions[i].has_value()) {
+                auto to = state_for(reached[i].pc + 1);
+                if (!to.has_value()) {
+                    return std::nullopt;
+                }
+                target_transitions[i] = add_actions(reached[i].actions, to.value());
+            }
+            transitions[class_index] = target_transitions[i].value();
+        }
+
+        automaton.m_transitions.insert(
+            automaton.m_transitions.end(),
+            transitions.begin(),
+            transitions.end());
+        automaton.m_accept_transitions.push_back(accept);
+    }
+    return automaton;
+}
+
+StateId Automaton::start_state() const {
+    return 0;
+}
+
+const Automaton::Transition& Automaton::transition(StateId from, char32_t c) const {
+    return m_transitions[from * m_alphabet.num_classes() + m_alphabet.class_of(c)];
+}
+
+const Automaton::Transition& Automaton::accept_transition(StateId state) const {
+    return m_accept_transitions[state];
+}
+
+std::span<const SlotAction> Automaton::actions(const Transition& transition) const {
+    return std::span(m_actions).subspan(
+        transition.actions_begin,
+        transition.actions_end - transition.actions_begin);
+}
+
+}  // namespace wr22::regex_executor::algorithms::one_pass
@@ -0,0 +1,55 @@
+// wr22
+#include <wr22/regex_executor/algorithms/one_pass/automaton.hpp>
+#include <wr22/regex_executor/algorithms/one_pass/executor.hpp>
+
+// stl
+#include <algorithm>
+
+namespace wr22::regex_executor::algorithms::one_pass {
+
+Executor::Executor(const Regex& regex_ref)
+    : m_regex_ref(regex_ref), m_slot_layout(regex_ref.program()),
+      m_slots(m_slot_layout.num_slots(), pike_vm::unset_slot) {}
+
+const Regex& Executor::regex_ref() const {
+    return m_regex_ref.get();
+}
+
+std::optional<MatchResult> Executor::execute(const std::u32string_view& string) {
+    const auto& maybe_automaton = regex_ref().one_pass_automaton();
+    if (!maybe_automaton.has_value()) {
+        return std::nullopt;
+    }
+    const auto& automaton = maybe_automaton.value();
+
+    std::fill(m_slots.begin(), m_slots.end(), pike_vm::unset_slot);
+    auto run_actions = [this, &automaton](const Automaton::Transition& transition, size_t cursor) {
+        for (const auto& action : automaton.actions(transition)) {
+            m_slots[action.slot] =
+                action.source_slot.has_value() ? m_slots[action.source_slot.value()] : cursor;
+        }
+    };
+
+    auto state = automaton.start_state();
+    for (size_t cursor = 0; cursor < string.size(); ++cursor) {
+        const auto& transition = automaton.transition(state, string[cursor]);
+        if (transition.to == Automaton::dead_state) {
+            return MatchResult{.matched = false};
+        }
+        run_actions(transition, cursor);
+        state = transition.to;
+    }
+    const auto& accept = automaton.accept_transition(state);
+    if (accept.to == Automaton::dead_state) {
+        return MatchResult{.matched = false};
+    }
+    run_actions(accept, string.size());
+    m_slots[m_slot_layout.match_begin_slot()] = 0;
+    m_slots[m_slot_layout.match_end_slot()] = string.size();
+    return MatchResult{
+        .matched = true,
+        .captures = m_slot_layout.make_captures(m_slots),
+    };
+}
+
+}  // namespace wr22::regex_executor::algorithms::one_pass
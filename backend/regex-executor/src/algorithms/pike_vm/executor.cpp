@@ -0,0 +1,247 @@
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/executor.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/thread_list.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/program/program.hpp>
+#include <wr22/regex_executor/program/start_filter.hpp>
+#include <wr22/utils/adt.hpp>
+
+// stl
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+namespace instruction = program::instruction;
+
+namespace {
+    class Vm {
+    public:
+        /// Create a VM that works in the buffers of `scratch`, which must outlive it.
+        Vm(const Regex& regex,
+           const SlotLayout& slot_layout,
+           const std::u32string_view& string_ref,
+           Fragment fragment,
+           MatchScratch& scratch);
+
+        /// Find a match that starts at `start` (or later, when searching). The VM can be run
+        /// any number of times.
+        std::optional<std::vector<size_t>> run(size_t start);
+
+    private:
+        /// Add a thread that starts matching at `cursor` with the lowest priority.
+        void start_thread(size_t cursor);
+        void add_thread(ThreadList& list, size_t pc, size_t cursor);
+        void set_slot(size_t slot, size_t value);
+
+        const program::Program& m_program;
+        const program::StartFilter& m_start_filter;
+        const SlotLayout& m_slot_layout;
+        std::u32string_view m_string_ref;
+        bool m_searching;
+        ThreadList& m_current;
+        ThreadList& m_next;
+        std::vector<size_t>& m_scratch_slots;
+        std::vector<Frame>& m_stack;
+    };
+
+    Vm::Vm(const Regex& regex,
+           const SlotLayout& slot_layout,
+           const std::u32string_view& string_ref,
+           Fragment fragment,
+           MatchScratch& scratch)
+        : m_program(regex.program()), m_start_filter(regex.start_filter()),
+          m_slot_layout(slot_layout), m_string_ref(string_ref),
+          m_searching(fragment != Fragment::Whole), m_current(scratch.current),
+          m_next(scratch.next), m_scratch_slots(scratch.slots), m_stack(scratch.stack) {
+        // A run that has thrown may have left frames behind.
+        m_stack.clear();
+    }
+
+    std::optional<std::vector<size_t>> Vm::run(size_t start) {
+        m_current.clear();
+        m_next.clear();
+        auto matched_slots = std::optional<std::vector<size_t>>();
+        for (size_t cursor = start;; ++cursor) {
+            // When searching, a new attempt to match starts at every position until a match is
+            // found. Attempts that start later have a lower priority.
+            if (!matched_slots.has_value() && (m_searching || cursor == start)) {
+                if (m_searching && m_current.empty()) {
+                    // No attempt is in progress: skip the positions no match can start at.
+                    auto candidate = m_start_filter.next_candidate(m_program, m_string_ref, cursor);
+                    if (!candidate.has_value()) {
+                        break;
+                    }
+                    cursor = candidate.value();
+                }
+                start_thread(cursor);
+            }
+            if (m_current.empty()) {
+                break;
+            }
+
+            auto c = cursor < m_string_ref.size() ? std::optional(m_string_ref[cursor])
+                                                  : std::nullopt;
+            for (size_t i = 0; i < m_current.size(); ++i) {
+                auto pc = m_current.pc_at(i);
+                const auto& instruction = m_program.instructions[pc];
+                if (std::holds_alternative<instruction::Match>(instruction.as_variant())) {
+                    if (m_searching || !c.has_value()) {
+                        // This is the highest priority thread that matches: the threads after it
+                        // can only lead to less preferred matches, so they are dropped. The
+                        // threads before it may still find a preferred match later.
+                        auto slots = m_current.slots_at(pc);
+                        matched_slots.emplace(slots.begin(), slots.end());
+                        matched_slots.value()[m_slot_layout.match_end_slot()] = cursor;
+                        break;
+                    }
+                    continue;
+                }
+                if (c.has_value() && program::consumes(m_program, pc, c.value())) {
+                    auto slots = m_current.slots_at(pc);
+                    std::copy(slots.begin(), slots.end(), m_scratch_slots.begin());
+                    add_thread(m_next, pc + 1, cursor + 1);
+                }
+            }
+            if (!c.has_value()) {
+                break;
+            }
+            std::swap(m_current, m_next);
+            m_next.clear();
+        }
+        return matched_slots;
+    }
+
+    void Vm::start_thread(size_t cursor) {
+        std::fill(m_scratch_slots.begin(), m_scratch_slots.end(), unset_slot);
+        m_scratch_slots[m_slot_layout.match_begin_slot()] = cursor;
+        add_thread(m_current, 0, cursor);
+    }
+
+    /// Add a thread at `pc` with the slots from `m_scratch_slots`, following all the epsilon
+    /// transitions in the order of priority. `m_scratch_slots` is left unchanged.
+    void Vm::add_thread(ThreadList& list, size_t pc, size_t cursor) {
+        m_stack.push_back(frame::Explore{.pc = pc});
+        while (!m_stack.empty()) {
+            auto top = m_stack.back();
+            m_stack.pop_back();
+            if (const auto* restore = std::get_if<frame::RestoreSlot>(&top.as_variant())) {
+                m_scratch_slots[restore->slot] = restore->value;
+                continue;
+            }
+
+            auto current_pc = std::get<frame::Explore>(top.as_variant()).pc;
+            while (list.insert(current_pc)) {
+                auto next_pc = m_program.instructions[current_pc].visit(
+                    [this](const instruction::Alternatives& instruction)
+                        -> std::optional<size_t> {
+                        const auto& targets = instruction.targets;
+                        for (auto it = targets.rbegin(); it + 1 != targets.rend(); ++it) {
+                            m_stack.push_back(frame::Explore{.pc = *it});
+                        }
+                        return targets.front();
+                    },
+                    [](const instruction::FinishAlternative& instruction)
+                        -> std::optional<size_t> { return instruction.target; },
+                    [this, current_pc, cursor](const instruction::BeginGroup& instruction)
+                        -> std::optional<size_t> {
+                        auto group = m_slot_layout.group_of_register(instruction.position_register);
+                        if (group.has_value()) {
+                            set_slot(m_slot_layout.entry_slot(group.value()), cursor);
+                        }
+                        return current_pc + 1;
+                    },
+                    [this, current_pc, cursor](const instruction::EndGroup& instruction)
+                        -> std::optional<size_t> {
+                        if (instruction.capture_slot.has_value()) {
+                            auto group =
+                                m_slot_layout.group_of_register(instruction.position_register);
+                            auto capture_slot = instruction.capture_slot.value();
+                            auto entry = m_scratch_slots[m_slot_layout.entry_slot(group.value())];
+                            set_slot(SlotLayout::begin_slot(capture_slot), entry);
+                            set_slot(SlotLayout::end_slot(capture_slot), cursor);
+                        }
+                        return current_pc + 1;
+                    },
+                    [current_pc]([[maybe_unused]] const instruction::BeginQuantifier& instruction)
+                        -> std::optional<size_t> { return current_pc + 1; },
+                    [this](const instruction::QuantifierSplit& instruction)
+                        -> std::optional<size_t> {
+                        m_stack.push_back(frame::Explore{.pc = instruction.exit});
+                        return instruction.body;
+                    },
+                    [](const instruction::EndIteration& instruction) -> std::optional<size_t> {
+                        return instruction.target;
+                    },
+                    [current_pc]([[maybe_unused]] const instruction::EndQuantifier& instruction)
+                        -> std::optional<size_t> { return current_pc + 1; },
+                    [this, &list, current_pc]([[maybe_unused]] const auto& instruction)
+                        -> std::optional<size_t> {
+                        // A consuming instruction or `Match`: the thread stops here until the
+                        // next input character.
+                        auto slots = list.slots_at(current_pc);
+                        std::copy(m_scratch_slots.begin(), m_scratch_slots.end(), slots.begin());
+                        return std::nullopt;
+                    });
+                if (!next_pc.has_value()) {
+                    break;
+                }
+                current_pc = next_pc.value();
+            }
+        }
+    }
+
+    void Vm::set_slot(size_t slot, size_t value) {
+        m_stack.push_back(frame::RestoreSlot{.slot = slot, .value = m_scratch_slots[slot]});
+        m_scratch_slots[slot] = value;
+    }
+}  // namespace
+
+Executor::Executor(const Regex& regex_ref)
+    : m_regex_ref(regex_ref), m_slot_layout(regex_ref.program()),
+      m_scratch(regex_ref.program().instructions.size(), m_slot_layout.num_slots()) {}
+
+const Regex& Executor::regex_ref() const {
+    return m_regex_ref.get();
+}
+
+MatchResult Executor::execute(const std::u32string_view& string, Fragment fragment) {
+    auto vm = Vm(regex_ref(), m_slot_layout, string, fragment, m_scratch);
+    if (fragment == Fragment::All) {
+        // Reuse the same VM, with its thread lists, for all the matches.
+        auto matches = std::vector<Captures>();
+        for (size_t start = 0; start <= string.size();) {
+            auto slots = vm.run(start);
+            if (!slots.has_value()) {
+                break;
+            }
+            auto begin = slots.value()[m_slot_layout.match_begin_slot()];
+            auto end = slots.value()[m_slot_layout.match_end_slot()];
+            matches.push_back(m_slot_layout.make_captures(slots.value()));
+            // After an empty match, skip a character so as not to find the same match again.
+            start = end == begin ? end + 1 : end;
+        }
+        if (matches.empty()) {
+            return MatchResult{.matched = false, .matches = std::move(matches)};
+        }
+        auto first = matches.front();
+        return MatchResult{
+            .matched = true,
+            .captures = std::move(first),
+            .matches = std::move(matches),
+        };
+    }
+
+    auto slots = vm.run(0);
+    if (!slots.has_value()) {
+        return MatchResult{.matched = false};
+    }
+    return MatchResult{
+        .matched = true,
+        .captures = m_slot_layout.make_captures(slots.value()),
+    };
+}
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
@@ -0,0 +1,11 @@
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/match_scratch.hpp>
+#include <wr22/regex_executor/algorithms/pike_vm/slot_layout.hpp>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+MatchScratch::MatchScratch(size_t num_instructions, size_t num_slots)
+    : current(num_instructions, num_slots), next(num_instructions, num_slots),
+      slots(num_slots, unset_slot) {}
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
@@ -0,0 +1,62 @@
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/slot_layout.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_parser/span/span.hpp>
+
+// stl
+#include <variant>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+namespace instruction = program::instruction;
+
+SlotLayout::SlotLayout(const program::Program& program)
+    : m_program(program), m_group_of_register(program.num_registers) {
+    for (const auto& instruction : program.instructions) {
+        const auto* end_group = std::get_if<instruction::EndGroup>(&instruction.as_variant());
+        if (end_group == nullptr || !end_group->capture_slot.has_value()) {
+            continue;
+        }
+        m_group_of_register.at(end_group->position_register) = m_num_groups++;
+    }
+}
+
+size_t SlotLayout::num_slots() const {
+    return m_program.get().capture_slots.size() * 2 + m_num_groups + 2;
+}
+
+std::optional<size_t> SlotLayout::group_of_register(size_t position_register) const {
+    return m_group_of_register.at(position_register);
+}
+
+size_t SlotLayout::begin_slot(size_t capture_slot) {
+    return capture_slot * 2;
+}
+
+size_t SlotLayout::end_slot(size_t capture_slot) {
+    return capture_slot * 2 + 1;
+}
+
+size_t SlotLayout::entry_slot(size_t group) const {
+    return m_program.get().capture_slots.size() * 2 + group;
+}
+
+size_t SlotLayout::match_begin_slot() const {
+    return entry_slot(m_num_groups);
+}
+
+size_t SlotLayout::match_end_slot() const {
+    return entry_slot(m_num_groups) + 1;
+}
+
+Captures SlotLayout::make_captures(std::span<const size_t> slots) const {
+    auto whole = Capture{
+        .string_span = regex_parser::span::Span::make_from_positions(
+            slots[match_begin_slot()],
+            slots[match_end_slot()]),
+    };
+    const auto& program = m_program.get();
+    return program::make_captures(program, whole, slots.first(program.capture_slots.size() * 2));
+}
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
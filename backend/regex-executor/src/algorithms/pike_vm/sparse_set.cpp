@@ -0,0 +1,39 @@
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/sparse_set.hpp>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+SparseSet::SparseSet(size_t capacity) : m_dense(capacity), m_sparse(capacity) {}
+
+bool SparseSet::insert(size_t value) {
+    if (contains(value)) {
+        return false;
+    }
+    m_dense.at(m_size) = value;
+    m_sparse.at(value) = m_size;
+    ++m_size;
+    return true;
+}
+
+bool SparseSet::contains(size_t value) const {
+    auto index = m_sparse.at(value);
+    return index < m_size && m_dense[index] == value;
+}
+
+void SparseSet::clear() {
+    m_size = 0;
+}
+
+size_t SparseSet::size() const {
+    return m_size;
+}
+
+bool SparseSet::empty() const {
+    return m_size == 0;
+}
+
+size_t SparseSet::at(size_t index) const {
+    return m_dense.at(index);
+}
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
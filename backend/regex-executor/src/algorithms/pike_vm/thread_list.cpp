@@ -0,0 +1,38 @@
+// wr22
+#include <wr22/regex_executor/algorithms/pike_vm/thread_list.hpp>
+
+namespace wr22::regex_executor::algorithms::pike_vm {
+
+ThreadList::ThreadList(size_t num_instructions, size_t num_slots)
+    : m_pcs(num_instructions), m_num_slots(num_slots),
+      m_slots(num_instructions * num_slots) {}
+
+bool ThreadList::insert(size_t pc) {
+    return m_pcs.insert(pc);
+}
+
+void ThreadList::clear() {
+    m_pcs.clear();
+}
+
+size_t ThreadList::size() const {
+    return m_pcs.size();
+}
+
+bool ThreadList::empty() const {
+    return m_pcs.empty();
+}
+
+size_t ThreadList::pc_at(size_t index) const {
+    return m_pcs.at(index);
+}
+
+std::span<size_t> ThreadList::slots_at(size_t pc) {
+    return std::span<size_t>(m_slots).subspan(pc * m_num_slots, m_num_slots);
+}
+
+std::span<const size_t> ThreadList::slots_at(size_t pc) const {
+    return std::span<const size_t>(m_slots).subspan(pc * m_num_slots, m_num_slots);
+}
+
+}  // namespace wr22::regex_executor::algorithms::pike_vm
@@ -1,16 +1,213 @@
 // wr22
 #include <wr22/regex_executor/executor.hpp>
+#include <wr22/regex_executor/utils/thread_pool.hpp>
+
+// stl
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
 
 namespace wr22::regex_executor {
 
-Executor::Executor(const Regex& regex_ref) : m_executor(regex_ref) {}
+Executor::Executor(const Regex& regex_ref)
+    : m_backtracking_executor(regex_ref), m_pike_vm_executor(regex_ref),
+      m_lazy_dfa_executor(regex_ref, Fragment::Whole),
+      m_lazy_dfa_search_executor(regex_ref, Fragment::Search),
+      m_parallel_lazy_dfa_executor(regex_ref, Fragment::Whole),
+      m_parallel_lazy_dfa_search_executor(regex_ref, Fragment::Search),
+      m_one_pass_executor(regex_ref), m_bit_parallel_executor(regex_ref), m_planner(regex_ref) {}
 
 const Regex& Executor::regex_ref() const {
-    return m_executor.regex_ref();
+    return m_backtracking_executor.regex_ref();
+}
+
+const Planner& Executor::planner() const {
+    return m_planner;
+}
+
+MatchResult Executor::execute(const std::u32string_view& string, const MatchOptions& options) {
+    if (!options.algorithm.has_value()) {
+        return execute(string, m_planner.plan(options, string.size()));
+    }
+    auto algorithm = runnable_algorithm(options.algorithm.value(), options.fragment);
+    // Recorded steps are the point of running the backtracking algorithm, so it is not skipped
+    // then.
+    auto records_steps = algorithm == Algorithm::Backtracking && options.record_steps;
+    if (!records_steps && !regex_ref().prefilter().may_match(string, options.fragment)) {
+        auto result = MatchResult{.algorithm = algorithm, .matched = false};
+        if (options.fragment == Fragment::All) {
+            result.matches = std::vector<Captures>();
+        }
+        return result;
+    }
+
+    switch (algorithm) {
+    case Algorithm::Backtracking: {
+        auto result = m_backtracking_executor.execute(string, options);
+        return MatchResult{
+            .algorithm = Algorithm::Backtracking,
+            .matched = result.matched,
+            .captures = std::move(result.captures),
+            .matches = std::move(result.matches),
+            .steps = std::move(result.steps),
+        };
+    }
+    case Algorithm::PikeVm: {
+        auto result = m_pike_vm_executor.execute(string, options.fragment);
+        return MatchResult{
+            .algorithm = Algorithm::PikeVm,
+            .matched = result.matched,
+            .captures = std::move(result.captures),
+            .matches = std::move(result.matches),
+        };
+    }
+    case Algorithm::LazyDfa: {
+        auto searching = options.fragment == Fragment::Search;
+        auto result = std::optional<algorithms::lazy_dfa::MatchResult>();
+        if (options.max_threads != 1) {
+            auto& parallel_executor = searching ? m_parallel_lazy_dfa_search_executor
+                                                : m_parallel_lazy_dfa_executor;
+            result = parallel_executor.execute(string, options.max_threads);
+        } else {
+            auto& lazy_dfa_executor = searching ? m_lazy_dfa_search_executor : m_lazy_dfa_executor;
+            result = lazy_dfa_executor.execute(string);
+        }
+        if (!result.has_value()) {
+            // The DFA state cache thrashes: simulate the NFA instead.
+            auto fallback_options = options;
+            fallback_options.algorithm = Algorithm::PikeVm;
+            return execute(string, fallback_options);
+        }
+        return MatchResult{
+            .algorithm = Algorithm::LazyDfa,
+            .matched = result.value().matched,
+        };
+    }
+    case Algorithm::BitParallel: {
+        // `runnable_algorithm` has checked that the regex fits in a single word.
+        auto result = m_bit_parallel_executor.execute(string, options.fragment).value();
+        return MatchResult{
+            .algorithm = Algorithm::BitParallel,
+            .matched = result.matched,
+        };
+    }
+    case Algorithm::OnePass: {
+        // `runnable_algorithm` has checked that the regex is one-pass.
+        auto result = m_one_pass_executor.execute(string).value();
+        return MatchResult{
+            .algorithm = Algorithm::OnePass,
+            .matched = result.matched,
+            .captures = std::move(result.captures),
+        };
+    }
+    }
+}
+
+Algorithm Executor::runnable_algorithm(Algorithm algorithm, Fragment fragment) const {
+    if (algorithm == Algorithm::OnePass
+        && (fragment != Fragment::Whole || !regex_ref().one_pass_automaton().has_value())) {
+        // The one-pass DFA only matches whole strings against one-pass regexes: simulate the
+        // NFA instead.
+        return Algorithm::PikeVm;
+    }
+    if (algorithm == Algorithm::BitParallel && !regex_ref().bit_parallel_automaton().has_value()) {
+        // The regex is too long for a single word.
+        algorithm = Algorithm::LazyDfa;
+    }
+    if (fragment == Fragment::All
+        && (algorithm == Algorithm::LazyDfa || algorithm == Algorithm::BitParallel)) {
+        // Neither can tell where the matches are: simulate the NFA instead.
+        return Algorithm::PikeVm;
+    }
+    return algorithm;
 }
 
-Executor::BacktrackingResult Executor::execute(const std::u32string_view& string) {
-    return m_executor.execute(string);
+MatchResult Executor::execute(
+    const std::u32string_view& string,
+    const MatchOptions& options,
+    algorithms::backtracking::StepSink& step_sink) {
+    auto result = m_backtracking_executor.execute(string, options, step_sink);
+    return MatchResult{
+        .algorithm = Algorithm::Backtracking,
+        .matched = result.matched,
+        .captures = std::move(result.captures),
+        .matches = std::move(result.matches),
+    };
+}
+
+MatchResult Executor::find_all(const std::u32string_view& string, const MatchOptions& options) {
+    auto all_options = options;
+    all_options.fragment = Fragment::All;
+    return execute(string, all_options);
+}
+
+std::vector<MatchResult> Executor::execute_batch(
+    std::span<const std::u32string_view> strings,
+    const MatchOptions& options,
+    size_t num_threads) {
+    auto all_options = std::vector<MatchOptions>(strings.size(), options);
+    return execute_batch(strings, all_options, num_threads);
+}
+
+std::vector<MatchResult> Executor::execute_batch(
+    std::span<const std::u32string_view> strings,
+    std::span<const MatchOptions> options,
+    size_t num_threads) {
+    if (options.size() != strings.size()) {
+        throw std::invalid_argument("Every string must have its match options");
+    }
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    auto total_length = std::accumulate(
+        strings.begin(),
+        strings.end(),
+        size_t(0),
+        [](size_t length, std::u32string_view string) { return length + string.size(); });
+    if (total_length < min_parallel_batch_length) {
+        num_threads = 1;
+    }
+    auto& pool = utils::ThreadPool::shared();
+    num_threads = std::min({num_threads, strings.size(), pool.num_threads() + 1});
+    auto num_helpers = num_threads == 0 ? 0 : num_threads - 1;
+    while (m_batch_executors.size() < num_helpers) {
+        m_batch_executors.push_back(std::make_unique<Executor>(regex_ref()));
+    }
+
+    auto results = std::vector<MatchResult>(strings.size());
+    auto errors = std::vector<std::exception_ptr>(strings.size());
+    auto next_index = std::atomic<size_t>(0);
+    auto failed = std::atomic<bool>(false);
+    auto work = [&](size_t worker_index) {
+        auto& executor = worker_index == 0 ? *this : *m_batch_executors.at(worker_index - 1);
+        while (!failed.load(std::memory_order_relaxed)) {
+            auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+            if (index >= strings.size()) {
+                return;
+            }
+            try {
+                results[index] = executor.execute(strings[index], options[index]);
+            } catch (...) {
+                errors[index] = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    if (num_helpers == 0) {
+        work(0);
+    } else {
+        pool.run(num_helpers, work);
+    }
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
 }
 
 }  // namespace wr22::regex_executor
@@ -0,0 +1,26 @@
+// wr22
+#include <wr22/regex_executor/fragment.hpp>
+
+namespace wr22::regex_executor {
+
+const char* fragment_name(Fragment fragment) {
+    switch (fragment) {
+    case Fragment::Whole:
+        return "whole";
+    case Fragment::Search:
+        return "search";
+    case Fragment::All:
+        return "all";
+    }
+}
+
+std::optional<Fragment> fragment_from_name(std::string_view name) {
+    for (auto fragment : {Fragment::Whole, Fragment::Search, Fragment::All}) {
+        if (name == fragment_name(fragment)) {
+            return fragment;
+        }
+    }
+    return std::nullopt;
+}
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,42 @@
+// wr22
+#include <wr22/regex_executor/match_budget.hpp>
+
+// fmt
+#include <fmt/core.h>
+
+namespace wr22::regex_executor {
+
+namespace {
+    const char* reason_description(BudgetExceeded::Reason reason) {
+        switch (reason) {
+        case BudgetExceeded::Reason::Steps:
+            return "too many steps";
+        case BudgetExceeded::Reason::Decisions:
+            return "too many decisions";
+        case BudgetExceeded::Reason::Memory:
+            return "too much memory";
+        case BudgetExceeded::Reason::Deadline:
+            return "deadline exceeded";
+        }
+    }
+}  // namespace
+
+BudgetExceeded::BudgetExceeded(Reason reason, MatchStatistics statistics)
+    : std::runtime_error(fmt::format(
+        "Matching budget exceeded ({}) after {} steps and {} decisions, reaching string "
+        "position {}",
+        reason_description(reason),
+        statistics.steps,
+        statistics.decisions,
+        statistics.max_string_pos)),
+      m_reason(reason), m_statistics(statistics) {}
+
+BudgetExceeded::Reason BudgetExceeded::reason() const {
+    return m_reason;
+}
+
+const MatchStatistics& BudgetExceeded::statistics() const {
+    return m_statistics;
+}
+
+}  // namespace wr22::regex_executor
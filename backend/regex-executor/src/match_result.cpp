@@ -0,0 +1,24 @@
+// wr22
+#include <wr22/regex_executor/match_result.hpp>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+namespace wr22::regex_executor {
+
+void to_json(nlohmann::json& j, const MatchResult& result) {
+    j = nlohmann::json::object();
+    j["algorithm"] = result.algorithm;
+    j["matched"] = result.matched;
+    if (result.captures.has_value()) {
+        j["captures"] = result.captures.value();
+    }
+    if (result.matches.has_value()) {
+        j["matches"] = result.matches.value();
+    }
+    if (result.steps.has_value()) {
+        j["steps"] = result.steps.value();
+    }
+}
+
+}  // namespace wr22::regex_executor
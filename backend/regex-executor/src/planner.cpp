@@ -0,0 +1,201 @@
+// wr22
+#include <wr22/regex_executor/algorithms/lazy_dfa/parallel_executor.hpp>
+#include <wr22/regex_executor/planner.hpp>
+#include <wr22/regex_executor/program/char_class.hpp>
+
+// stl
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace wr22::regex_executor {
+
+namespace part = regex_parser::regex::part;
+using regex_parser::regex::SpannedPart;
+using Range = program::CompiledCharClass::Range;
+
+namespace {
+    constexpr auto max_char = std::numeric_limits<char32_t>::max();
+
+    /// What the risk analysis knows about a regex part.
+    struct RiskInfo {
+        /// The characters the part can consume anywhere, as sorted disjoint ranges.
+        std::vector<Range> chars;
+        bool nullable = false;
+        /// Whether the part contains an unbounded quantifier.
+        bool unbounded = false;
+        /// Whether the part is, up to groups, alternatives with overlapping characters.
+        bool overlapping_alternatives = false;
+    };
+
+    std::vector<Range> unite(std::vector<Range> lhs, const std::vector<Range>& rhs) {
+        lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+        return program::CompiledCharClass(std::move(lhs)).ranges();
+    }
+
+    bool overlap(const std::vector<Range>& lhs, const std::vector<Range>& rhs) {
+        auto lhs_it = lhs.begin();
+        auto rhs_it = rhs.begin();
+        while (lhs_it != lhs.end() && rhs_it != rhs.end()) {
+            if (lhs_it->last < rhs_it->first) {
+                ++lhs_it;
+            } else if (rhs_it->last < lhs_it->first) {
+                ++rhs_it;
+            } else {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Looks for the shapes of a regex that make backtracking take super-linear time.
+    class RiskAnalyzer {
+    public:
+        RiskInfo analyze(const SpannedPart& spanned_part) {
+            return spanned_part.part().visit(
+                []([[maybe_unused]] const part::Empty& part) {
+                    return RiskInfo{.nullable = true};
+                },
+                [](const part::Literal& part) {
+                    return RiskInfo{
+                        .chars = {Range{.first = part.character, .last = part.character}},
+                    };
+                },
+                []([[maybe_unused]] const part::Wildcard& part) {
+                    return RiskInfo{.chars = {Range{.first = 0, .last = max_char}}};
+                },
+                [](const part::CharacterClass& part) {
+                    return RiskInfo{.chars = program::CompiledCharClass(part.data).ranges()};
+                },
+                [this](const part::Sequence& part) {
+                    auto info = RiskInfo{.nullable = true};
+                    // The characters of the unbounded quantifiers that can end right before the
+                    // current item.
+                    auto open = std::vector<Range>();
+                    for (const auto& item : part.items) {
+                        auto item_info = analyze(item);
+                        if (item_info.unbounded && overlap(open, item_info.chars)) {
+                            m_risky = true;
+                        }
+                        auto item_open =
+                            item_info.unbounded ? item_info.chars : std::vector<Range>();
+                        open = item_info.nullable ? unite(std::move(open), item_open)
+                                                  : std::move(item_open);
+                        info.chars = unite(std::move(info.chars), item_info.chars);
+                        info.nullable = info.nullable && item_info.nullable;
+                        info.unbounded = info.unbounded || item_info.unbounded;
+                    }
+                    return info;
+                },
+                [this](const part::Group& part) { return analyze(*part.inner); },
+                [this](const part::Alternatives& part) {
+                    auto info = RiskInfo();
+                    for (const auto& alternative : part.alternatives) {
+                        auto alternative_info = analyze(alternative);
+                        if (overlap(info.chars, alternative_info.chars)) {
+                            info.overlapping_alternatives = true;
+                        }
+                        info.chars = unite(std::move(info.chars), alternative_info.chars);
+                        info.nullable = info.nullable || alternative_info.nullable;
+                        info.unbounded = info.unbounded || alternative_info.unbounded;
+                    }
+                    return info;
+                },
+                [this](const part::Optional& part) {
+                    auto info = analyze(*part.inner);
+                    info.nullable = true;
+                    info.overlapping_alternatives = false;
+                    return info;
+                },
+                [this](const part::Plus& part) { return analyze_unbounded(*part.inner, false); },
+                [this](const part::Star& part) { return analyze_unbounded(*part.inner, true); });
+        }
+
+        bool risky() const {
+            return m_risky;
+        }
+
+    private:
+        RiskInfo analyze_unbounded(const SpannedPart& inner, bool nullable) {
+            auto info = analyze(inner);
+            if (info.unbounded || info.overlapping_alternatives) {
+                m_risky = true;
+            }
+            info.nullable = info.nullable || nullable;
+            info.unbounded = true;
+            info.overlapping_alternatives = false;
+            return info;
+        }
+
+        bool m_risky = false;
+    };
+}  // namespace
+
+RegexProfile RegexProfile::of(const Regex& regex) {
+    auto risk_analyzer = RiskAnalyzer();
+    risk_analyzer.analyze(regex.root_part());
+    return RegexProfile{
+        .num_capture_slots = regex.program().capture_slots.size(),
+        .num_instructions = regex.program().instructions.size(),
+        .one_pass = regex.one_pass_automaton().has_value(),
+        .bit_parallel = regex.bit_parallel_automaton().has_value(),
+        .literal = regex.prefilter().exact().has_value(),
+        .empty_iterations = program::has_empty_unbounded_iteration(regex.program()),
+        .backtracking_risk = risk_analyzer.risky(),
+    };
+}
+
+Planner::Planner(const Regex& regex_ref) : m_profile(RegexProfile::of(regex_ref)) {}
+
+const RegexProfile& Planner::profile() const {
+    return m_profile;
+}
+
+MatchOptions Planner::plan(const MatchOptions& options, size_t string_length) const {
+    auto planned = options;
+    if (planned.algorithm.has_value()) {
+        return planned;
+    }
+
+    auto choose = [&planned](Algorithm algorithm) {
+        planned.algorithm = algorithm;
+        return planned;
+    };
+    if (options.record_steps || options.memoize) {
+        return choose(Algorithm::Backtracking);
+    }
+    if (!options.record_captures && options.fragment != Fragment::All) {
+        // Only the lazy DFA splits long strings between threads.
+        auto min_split_length =
+            2 * algorithms::lazy_dfa::ParallelExecutor::default_min_chunk_length;
+        auto split = options.max_threads != 1 && string_length >= min_split_length;
+        if (m_profile.bit_parallel && !split) {
+            return choose(Algorithm::BitParallel);
+        }
+        return choose(Algorithm::LazyDfa);
+    }
+    if (m_profile.one_pass && options.fragment == Fragment::Whole) {
+        return choose(Algorithm::OnePass);
+    }
+    if (m_profile.backtracking_risk) {
+        // Memoized backtracking finds the same captures as plain backtracking, which the Pike VM
+        // may not for empty iterations.
+        auto memoization_bits = m_profile.num_instructions * (string_length + 1);
+        auto prefers_memoization =
+            m_profile.empty_iterations || m_profile.num_capture_slots >= many_capture_slots;
+        if (prefers_memoization && memoization_bits <= max_memoization_bits) {
+            planned.memoize = true;
+            return choose(Algorithm::Backtracking);
+        }
+        return choose(Algorithm::PikeVm);
+    }
+    if (m_profile.literal || m_profile.empty_iterations) {
+        return choose(Algorithm::Backtracking);
+    }
+    if (options.fragment != Fragment::Whole && string_length >= long_string) {
+        return choose(Algorithm::PikeVm);
+    }
+    return choose(Algorithm::Backtracking);
+}
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,170 @@
+// wr22
+#include <wr22/regex_executor/prefilter.hpp>
+#include <wr22/regex_executor/program/run_length.hpp>
+
+// stl
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace wr22::regex_executor {
+
+namespace part = regex_parser::regex::part;
+using regex_parser::regex::SpannedPart;
+
+namespace {
+    /// What is known about the strings matched by a regex part.
+    struct LiteralInfo {
+        /// The only string the part can match, if there is one.
+        std::optional<std::u32string> exact;
+        /// The literal every string matched by the part starts with.
+        std::u32string prefix;
+        /// The literal every string matched by the part ends with.
+        std::u32string suffix;
+        /// The longest literal known to occur in every string matched by the part.
+        std::u32string required;
+
+        static LiteralInfo make_exact(std::u32string string) {
+            return LiteralInfo{
+                .exact = string,
+                .prefix = string,
+                .suffix = string,
+                .required = string,
+            };
+        }
+    };
+
+    void keep_longest(std::u32string& required, const std::u32string& candidate) {
+        if (candidate.size() > required.size()) {
+            required = candidate;
+        }
+    }
+
+    /// Info for a part that matches the concatenation of the strings matched by `lhs` and
+    /// `rhs`.
+    LiteralInfo concatenate(LiteralInfo lhs, LiteralInfo rhs) {
+        if (lhs.exact.has_value() && rhs.exact.has_value()) {
+            return LiteralInfo::make_exact(lhs.exact.value() + rhs.exact.value());
+        }
+        auto info = LiteralInfo{
+            .prefix = lhs.exact.has_value() ? lhs.exact.value() + rhs.prefix : lhs.prefix,
+            .suffix = rhs.exact.has_value() ? lhs.suffix + rhs.exact.value() : rhs.suffix,
+            .required = std::move(lhs.required),
+        };
+        keep_longest(info.required, rhs.required);
+        // The end of the left string and the start of the right one are adjacent.
+        keep_longest(info.required, lhs.suffix + rhs.prefix);
+        keep_longest(info.required, info.prefix);
+        keep_longest(info.required, info.suffix);
+        return info;
+    }
+
+    /// Info for a part that matches any of the strings matched by `lhs` and `rhs`.
+    LiteralInfo unite(LiteralInfo lhs, const LiteralInfo& rhs) {
+        if (lhs.exact.has_value() && lhs.exact == rhs.exact) {
+            return lhs;
+        }
+        auto prefix_end = std::mismatch(
+                              lhs.prefix.begin(),
+                              lhs.prefix.end(),
+                              rhs.prefix.begin(),
+                              rhs.prefix.end())
+                              .first;
+        auto suffix_end = std::mismatch(
+                              lhs.suffix.rbegin(),
+                              lhs.suffix.rend(),
+                              rhs.suffix.rbegin(),
+                              rhs.suffix.rend())
+                              .first;
+        auto info = LiteralInfo{
+            .prefix = std::u32string(lhs.prefix.begin(), prefix_end),
+            .suffix = std::u32string(suffix_end.base(), lhs.suffix.end()),
+        };
+        info.required = info.prefix.size() >= info.suffix.size() ? info.prefix : info.suffix;
+        return info;
+    }
+
+    LiteralInfo analyze(const SpannedPart& spanned_part) {
+        return spanned_part.part().visit(
+            []([[maybe_unused]] const part::Empty& part) {
+                return LiteralInfo::make_exact(U"");
+            },
+            [](const part::Literal& part) {
+                return LiteralInfo::make_exact(std::u32string(1, part.character));
+            },
+            []([[maybe_unused]] const part::Wildcard& part) { return LiteralInfo{}; },
+            [](const part::CharacterClass& part) {
+                const auto& ranges = part.data.ranges;
+                if (!part.data.inverted && ranges.size() == 1
+                    && ranges.front().range.is_single_character()) {
+                    return LiteralInfo::make_exact(
+                        std::u32string(1, ranges.front().range.first()));
+                }
+                return LiteralInfo{};
+            },
+            [](const part::Sequence& part) {
+                auto info = LiteralInfo::make_exact(U"");
+                for (const auto& item : part.items) {
+                    info = concatenate(std::move(info), analyze(item));
+                }
+                return info;
+            },
+            [](const part::Group& part) { return analyze(*part.inner); },
+            [](const part::Alternatives& part) {
+                auto info = analyze(part.alternatives.front());
+                for (size_t i = 1; i < part.alternatives.size(); ++i) {
+                    info = unite(std::move(info), analyze(part.alternatives[i]));
+                }
+                return info;
+            },
+            [](const part::Optional& part) {
+                return unite(analyze(*part.inner), LiteralInfo::make_exact(U""));
+            },
+            [](const part::Plus& part) {
+                // At least one repetition: whatever starts, ends or is contained in it also
+                // starts, ends or is contained in the whole.
+                auto info = analyze(*part.inner);
+                if (info.exact.has_value() && !info.exact.value().empty()) {
+                    info.exact = std::nullopt;
+                }
+                return info;
+            },
+            [](const part::Star& part) {
+                return unite(analyze(*part.inner), LiteralInfo::make_exact(U""));
+            });
+    }
+}  // namespace
+
+Prefilter::Prefilter(const SpannedPart& root_part) {
+    auto info = analyze(root_part);
+    m_prefix = std::move(info.prefix);
+    m_suffix = std::move(info.suffix);
+    m_required = std::move(info.required);
+    m_exact = std::move(info.exact);
+}
+
+const std::u32string& Prefilter::prefix() const {
+    return m_prefix;
+}
+
+const std::u32string& Prefilter::suffix() const {
+    return m_suffix;
+}
+
+const std::u32string& Prefilter::required() const {
+    return m_required;
+}
+
+const std::optional<std::u32string>& Prefilter::exact() const {
+    return m_exact;
+}
+
+bool Prefilter::may_match(std::u32string_view string, Fragment fragment) const {
+    if (fragment == Fragment::Whole) {
+        return string.starts_with(m_prefix) && string.ends_with(m_suffix)
+            && program::find_literal(string, m_required) != std::u32string_view::npos;
+    }
+    return program::find_literal(string, m_required) != std::u32string_view::npos;
+}
+
+}  // namespace wr22::regex_executor
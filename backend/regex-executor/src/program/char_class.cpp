@@ -0,0 +1,98 @@
+// wr22
+#include <wr22/regex_executor/program/char_class.hpp>
+
+// stl
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+namespace wr22::regex_executor::program {
+
+namespace {
+    constexpr auto max_char = std::numeric_limits<char32_t>::max();
+
+    /// Sort the ranges and merge the overlapping and adjacent ones.
+    std::vector<CompiledCharClass::Range> normalize(std::vector<CompiledCharClass::Range> ranges) {
+        std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        auto merged = std::vector<CompiledCharClass::Range>();
+        for (const auto& range : ranges) {
+            if (!merged.empty()
+                && (merged.back().last == max_char || range.first <= merged.back().last + 1)) {
+                merged.back().last = std::max(merged.back().last, range.last);
+            } else {
+                merged.push_back(range);
+            }
+        }
+        return merged;
+    }
+
+    /// Get the ranges of the characters not covered by the normalized `ranges`.
+    std::vector<CompiledCharClass::Range> complement(
+        const std::vector<CompiledCharClass::Range>& ranges) {
+        auto result = std::vector<CompiledCharClass::Range>();
+        char32_t next = 0;
+        for (const auto& range : ranges) {
+            if (range.first > next) {
+                result.push_back({.first = next, .last = range.first - 1});
+            }
+            if (range.last == max_char) {
+                return result;
+            }
+            next = range.last + 1;
+        }
+        result.push_back({.first = next, .last = max_char});
+        return result;
+    }
+}  // namespace
+
+CompiledCharClass::CompiledCharClass(const regex_parser::regex::CharacterClassData& data) {
+    auto ranges = std::vector<Range>();
+    ranges.reserve(data.ranges.size());
+    for (const auto& range : data.ranges) {
+        ranges.push_back({.first = range.range.first(), .last = range.range.last()});
+    }
+    m_ranges = normalize(std::move(ranges));
+    if (data.inverted) {
+        m_ranges = complement(m_ranges);
+    }
+    fill_ascii();
+}
+
+CompiledCharClass::CompiledCharClass(std::vector<Range> ranges)
+    : m_ranges(normalize(std::move(ranges))) {
+    fill_ascii();
+}
+
+void CompiledCharClass::fill_ascii() {
+    for (const auto& range : m_ranges) {
+        if (range.first >= m_ascii.size()) {
+            break;
+        }
+        auto last = std::min<char32_t>(range.last, m_ascii.size() - 1);
+        for (auto c = range.first; c <= last; ++c) {
+            m_ascii[c] = true;
+        }
+    }
+}
+
+bool CompiledCharClass::matches(char32_t c) const {
+    if (c < m_ascii.size()) {
+        return m_ascii[c];
+    }
+    // Find the last range that starts at or before `c`.
+    auto it = std::upper_bound(
+        m_ranges.begin(),
+        m_ranges.end(),
+        c,
+        [](char32_t c, const Range& range) { return c < range.first; });
+    return it != m_ranges.begin() && c <= std::prev(it)->last;
+}
+
+const std::vector<CompiledCharClass::Range>& CompiledCharClass::ranges() const {
+    return m_ranges;
+}
+
+}  // namespace wr22::regex_executor::program
@@ -0,0 +1,348 @@
+// wr22
+#include <wr22/regex_executor/program/compiler.hpp>
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/quantifier_type.hpp>
+#include <wr22/regex_parser/regex/capture.hpp>
+
+// stl
+#include <algorithm>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+namespace part = regex_parser::regex::part;
+using regex_parser::regex::SpannedPart;
+using regex_parser::span::Span;
+
+namespace {
+    class Compiler {
+    public:
+        void compile_part(const SpannedPart& spanned_part);
+        void compile_match(Span span);
+        Program into_program() &&;
+
+    private:
+        void compile_quantifier(QuantifierType type, const SpannedPart& inner, Span span);
+
+        size_t emit(Instruction instruction, Span span);
+        size_t next_pc() const;
+        /// Whether the instruction at `pc` consumes exactly one character.
+        bool consumes_one_char(size_t pc) const;
+        size_t allocate_register();
+        /// Get the capture slot shared by the groups with a given name, adding it if needed.
+        size_t named_capture_slot(const std::string& name);
+
+        template <typename T>
+        T& instruction_at(size_t pc) {
+            return std::get<T>(m_program.instructions.at(pc).as_variant());
+        }
+
+        Program m_program;
+    };
+
+    /// Find out what can follow each quantifier once it stops repeating, filling in
+    /// `QuantifierSplit::exit_follow`.
+    void add_exit_follows(Program& program) {
+        auto visited = std::vector<bool>(program.instructions.size());
+        auto stack = std::vector<size_t>();
+        for (auto& instruction : program.instructions) {
+            auto* split = std::get_if<instruction::QuantifierSplit>(&instruction.as_variant());
+            if (split == nullptr) {
+                continue;
+            }
+
+            // Collect the characters consumed by the instructions reachable from the exit
+            // without consuming input.
+            auto ranges = std::vector<CompiledCharClass::Range>();
+            auto may_match = false;
+            auto consumes_any = false;
+            std::fill(visited.begin(), visited.end(), false);
+            stack.assign({split->exit});
+            while (!stack.empty() && !consumes_any) {
+                auto pc = stack.back();
+                stack.pop_back();
+                if (visited.at(pc)) {
+                    continue;
+                }
+                visited.at(pc) = true;
+                program.instructions.at(pc).visit(
+                    [&ranges](const instruction::Literal& instruction) {
+                        ranges.push_back(CompiledCharClass::Range{
+                            .first = instruction.character,
+                            .last = instruction.character,
+                        });
+                    },
+                    [&consumes_any]([[maybe_unused]] const instruction::Wildcard& instruction) {
+                        consumes_any = true;
+                    },
+                    [&ranges, &program](const instruction::CharClass& instruction) {
+                        const auto& class_ranges =
+                            program.char_classes.at(instruction.class_index).ranges();
+                        ranges.insert(ranges.end(), class_ranges.begin(), class_ranges.end());
+                    },
+                    [&may_match]([[maybe_unused]] const instruction::Match& instruction) {
+                        may_match = true;
+                    },
+                    [&stack](const instruction::Alternatives& instruction) {
+                        stack.insert(
+                            stack.end(),
+                            instruction.targets.begin(),
+                            instruction.targets.end());
+                    },
+                    [&stack](const instruction::FinishAlternative& instruction) {
+                        stack.push_back(instruction.target);
+                    },
+                    [&stack](const instruction::QuantifierSplit& instruction) {
+                        stack.push_back(instruction.body);
+                        stack.push_back(instruction.exit);
+                    },
+                    [&stack](const instruction::EndIteration& instruction) {
+                        stack.push_back(instruction.target);
+                    },
+                    [&stack, pc]([[maybe_unused]] const auto& instruction) {
+                        // Groups and quantifier bounds: continue with the next instruction.
+                        stack.push_back(pc + 1);
+                    });
+            }
+            if (consumes_any) {
+                continue;
+            }
+
+            auto class_index = program.char_classes.size();
+            program.char_classes.emplace_back(std::move(ranges));
+            split->exit_follow =
+                instruction::ExitFollow{.class_index = class_index, .may_match = may_match};
+        }
+    }
+
+    /// Find the runs of consecutive literals, filling in `Literal::run`.
+    void add_literal_runs(Program& program) {
+        auto literal_at = [&program](size_t pc) {
+            return std::get_if<instruction::Literal>(&program.instructions.at(pc).as_variant());
+        };
+        auto begin = size_t{0};
+        while (begin < program.instructions.size()) {
+            auto end = begin;
+            auto run = std::u32string();
+            while (end < program.instructions.size() && literal_at(end) != nullptr) {
+                run.push_back(literal_at(end)->character);
+                ++end;
+            }
+            if (run.size() >= 2) {
+                // The last literal of the run has nothing to be compared together with.
+                auto string_index = program.literal_runs.size();
+                for (auto pc = begin; pc + 1 < end; ++pc) {
+                    literal_at(pc)->run =
+                        instruction::LiteralRun{.string_index = string_index, .offset = pc - begin};
+                }
+                program.literal_runs.push_back(std::move(run));
+            }
+            begin = std::max(end, begin + 1);
+        }
+    }
+
+    void Compiler::compile_part(const SpannedPart& spanned_part) {
+        auto span = spanned_part.span();
+        spanned_part.part().visit(
+            []([[maybe_unused]] const part::Empty& part) {},
+            [this, span](const part::Literal& part) {
+                emit(instruction::Literal{.character = part.character}, span);
+            },
+            [this, span]([[maybe_unused]] const part::Wildcard& part) {
+                emit(instruction::Wildcard{}, span);
+            },
+            [this, span](const part::CharacterClass& part) {
+                auto class_index = m_program.char_classes.size();
+                m_program.char_classes.emplace_back(part.data);
+                emit(instruction::CharClass{.class_index = class_index}, span);
+            },
+            [this](const part::Sequence& part) {
+                for (const auto& item : part.items) {
+                    compile_part(item);
+                }
+            },
+            [this, span](const part::Group& part) {
+                namespace capture = regex_parser::regex::capture;
+                auto end_group = instruction::EndGroup{.position_register = allocate_register()};
+                // Indices are assigned before compiling the inner part, so that they follow the
+                // order of opening parentheses.
+                part.capture.visit(
+                    [this, &end_group]([[maybe_unused]] const capture::Index& rule) {
+                        end_group.capture_slot = m_program.capture_slots.size();
+                        m_program.capture_slots.push_back(
+                            CaptureSlot{.index = ++m_program.num_indexed_captures});
+                    },
+                    []([[maybe_unused]] const capture::None& rule) {},
+                    [this, &end_group](const capture::Name& rule) {
+                        end_group.capture_slot = named_capture_slot(rule.name);
+                    });
+
+                emit(
+                    instruction::BeginGroup{.position_register = end_group.position_register},
+                    span);
+                compile_part(*part.inner);
+                emit(std::move(end_group), span);
+            },
+            [this, span](const part::Alternatives& part) {
+                auto alternatives_pc = emit(
+                    instruction::Alternatives{.position_register = allocate_register()},
+                    span);
+                auto targets = std::vector<size_t>();
+                auto finish_pcs = std::vector<size_t>();
+                for (size_t i = 0; i < part.alternatives.size(); ++i) {
+                    targets.push_back(next_pc());
+                    compile_part(part.alternatives[i]);
+                    finish_pcs.push_back(emit(
+                        instruction::FinishAlternative{
+                            .alternatives_pc = alternatives_pc,
+                            .alternative_index = i,
+                        },
+                        span));
+                }
+
+                auto end = next_pc();
+                for (auto pc : finish_pcs) {
+                    instruction_at<instruction::FinishAlternative>(pc).target = end;
+                }
+                instruction_at<instruction::Alternatives>(alternatives_pc).targets =
+                    std::move(targets);
+            },
+            [this, span](const part::Optional& part) {
+                compile_quantifier(QuantifierType::Optional, *part.inner, span);
+            },
+            [this, span](const part::Plus& part) {
+                compile_quantifier(QuantifierType::Plus, *part.inner, span);
+            },
+            [this, span](const part::Star& part) {
+                compile_quantifier(QuantifierType::Star, *part.inner, span);
+            });
+    }
+
+    void Compiler::compile_quantifier(QuantifierType type, const SpannedPart& inner, Span span) {
+        auto quantifier_pc = emit(
+            instruction::BeginQuantifier{
+                .type = type,
+                .counter_register = allocate_register(),
+                .position_register = allocate_register(),
+                .iteration_register = allocate_register(),
+            },
+            span);
+
+        switch (type) {
+        case QuantifierType::Star: {
+            // begin; loop: split(body, exit); body: <inner>; end_iteration(loop); exit: end
+            auto split_pc = emit(
+                instruction::QuantifierSplit{
+                    .quantifier_pc = quantifier_pc,
+                    .body = quantifier_pc + 2,
+                },
+                span);
+            compile_part(inner);
+            auto single_char_body = next_pc() == split_pc + 2 && consumes_one_char(split_pc + 1);
+            emit(
+                instruction::EndIteration{.quantifier_pc = quantifier_pc, .target = split_pc},
+                span);
+            auto& split = instruction_at<instruction::QuantifierSplit>(split_pc);
+            split.exit = next_pc();
+            split.single_char_body = single_char_body;
+            break;
+        }
+        case QuantifierType::Plus: {
+            // begin; body: <inner>; end_iteration(split); split: split(body, exit); exit: end
+            auto body_pc = next_pc();
+            compile_part(inner);
+            auto single_char_body = next_pc() == body_pc + 1 && consumes_one_char(body_pc);
+            auto split_pc = next_pc() + 1;
+            emit(
+                instruction::EndIteration{.quantifier_pc = quantifier_pc, .target = split_pc},
+                span);
+            emit(
+                instruction::QuantifierSplit{
+                    .quantifier_pc = quantifier_pc,
+                    .body = body_pc,
+                    .exit = split_pc + 1,
+                    .single_char_body = single_char_body,
+                },
+                span);
+            break;
+        }
+        case QuantifierType::Optional: {
+            // begin; split(body, exit); body: <inner>; end_iteration(exit); exit: end
+            auto split_pc = emit(
+                instruction::QuantifierSplit{
+                    .quantifier_pc = quantifier_pc,
+                    .body = quantifier_pc + 2,
+                },
+                span);
+            compile_part(inner);
+            auto single_char_body = next_pc() == split_pc + 2 && consumes_one_char(split_pc + 1);
+            auto end_iteration_pc =
+                emit(instruction::EndIteration{.quantifier_pc = quantifier_pc}, span);
+            auto exit_pc = next_pc();
+            auto& split = instruction_at<instruction::QuantifierSplit>(split_pc);
+            split.exit = exit_pc;
+            split.single_char_body = single_char_body;
+            instruction_at<instruction::EndIteration>(end_iteration_pc).target = exit_pc;
+            break;
+        }
+        }
+
+        emit(instruction::EndQuantifier{.quantifier_pc = quantifier_pc}, span);
+    }
+
+    void Compiler::compile_match(Span span) {
+        emit(instruction::Match{}, span);
+    }
+
+    Program Compiler::into_program() && {
+        return std::move(m_program);
+    }
+
+    size_t Compiler::emit(Instruction instruction, Span span) {
+        auto pc = next_pc();
+        m_program.instructions.push_back(std::move(instruction));
+        m_program.spans.push_back(span);
+        return pc;
+    }
+
+    bool Compiler::consumes_one_char(size_t pc) const {
+        const auto& variant = m_program.instructions.at(pc).as_variant();
+        return std::holds_alternative<instruction::Literal>(variant)
+            || std::holds_alternative<instruction::Wildcard>(variant)
+            || std::holds_alternative<instruction::CharClass>(variant);
+    }
+
+    size_t Compiler::next_pc() const {
+        return m_program.instructions.size();
+    }
+
+    size_t Compiler::allocate_register() {
+        return m_program.num_registers++;
+    }
+
+    size_t Compiler::named_capture_slot(const std::string& name) {
+        auto& slots = m_program.capture_slots;
+        auto it = std::find_if(slots.begin(), slots.end(), [&name](const CaptureSlot& slot) {
+            return slot.name == name;
+        });
+        if (it != slots.end()) {
+            return static_cast<size_t>(it - slots.begin());
+        }
+        slots.push_back(CaptureSlot{.name = name});
+        return slots.size() - 1;
+    }
+}  // namespace
+
+Program compile(const regex_parser::regex::SpannedPart& root_part) {
+    auto compiler = Compiler();
+    compiler.compile_part(root_part);
+    compiler.compile_match(root_part.span());
+    auto program = std::move(compiler).into_program();
+    add_exit_follows(program);
+    add_literal_runs(program);
+    return program;
+}
+
+}  // namespace wr22::regex_executor::program
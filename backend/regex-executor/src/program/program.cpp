@@ -0,0 +1,102 @@
+// wr22
+#include <wr22/regex_executor/program/program.hpp>
+#include <wr22/regex_executor/quantifier_type.hpp>
+
+// stl
+#include <algorithm>
+#include <variant>
+#include <vector>
+
+namespace wr22::regex_executor::program {
+
+bool consumes(const Program& program, size_t pc, char32_t c) {
+    return program.instructions.at(pc).visit(
+        [c](const instruction::Literal& instruction) { return instruction.character == c; },
+        []([[maybe_unused]] const instruction::Wildcard& instruction) { return true; },
+        [&program, c](const instruction::CharClass& instruction) {
+            return program.char_classes.at(instruction.class_index).matches(c);
+        },
+        []([[maybe_unused]] const auto& instruction) { return false; });
+}
+
+std::vector<size_t> epsilon_successors(const Program& program, size_t pc) {
+    return program.instructions.at(pc).visit(
+        [](const instruction::Alternatives& instruction) { return instruction.targets; },
+        [](const instruction::FinishAlternative& instruction) {
+            return std::vector<size_t>{instruction.target};
+        },
+        [](const instruction::QuantifierSplit& instruction) {
+            return std::vector<size_t>{instruction.body, instruction.exit};
+        },
+        [](const instruction::EndIteration& instruction) {
+            return std::vector<size_t>{instruction.target};
+        },
+        [pc](const instruction::BeginGroup&) { return std::vector<size_t>{pc + 1}; },
+        [pc](const instruction::EndGroup&) { return std::vector<size_t>{pc + 1}; },
+        [pc](const instruction::BeginQuantifier&) { return std::vector<size_t>{pc + 1}; },
+        [pc](const instruction::EndQuantifier&) { return std::vector<size_t>{pc + 1}; },
+        []([[maybe_unused]] const auto& instruction) { return std::vector<size_t>(); });
+}
+
+bool has_empty_unbounded_iteration(const Program& program) {
+    auto visited = std::vector<bool>(program.instructions.size());
+    auto stack = std::vector<size_t>();
+    for (const auto& instr : program.instructions) {
+        const auto* split = std::get_if<instruction::QuantifierSplit>(&instr.as_variant());
+        if (split == nullptr) {
+            continue;
+        }
+        const auto& begin = std::get<instruction::BeginQuantifier>(
+            program.instructions.at(split->quantifier_pc).as_variant());
+        if (max_repetitions(begin.type).has_value()) {
+            continue;
+        }
+
+        std::fill(visited.begin(), visited.end(), false);
+        stack.assign({split->body});
+        while (!stack.empty()) {
+            auto pc = stack.back();
+            stack.pop_back();
+            if (visited.at(pc)) {
+                continue;
+            }
+            visited.at(pc) = true;
+            const auto* end_iteration =
+                std::get_if<instruction::EndIteration>(&program.instructions[pc].as_variant());
+            if (end_iteration != nullptr && end_iteration->quantifier_pc == split->quantifier_pc) {
+                return true;
+            }
+            for (auto successor : epsilon_successors(program, pc)) {
+                stack.push_back(successor);
+            }
+        }
+    }
+    return false;
+}
+
+Captures make_captures(
+    const Program& program,
+    Capture whole,
+    std::span<const size_t> capture_positions) {
+    auto captures = Captures{.whole = whole};
+    for (size_t slot = 0; slot < program.capture_slots.size(); ++slot) {
+        auto begin = capture_positions[slot * 2];
+        auto end = capture_positions[slot * 2 + 1];
+        if (begin == unset_capture_position) {
+            continue;
+        }
+        auto capture = Capture{
+            .string_span = regex_parser::span::Span::make_from_positions(begin, end),
+        };
+        const auto& info = program.capture_slots[slot];
+        if (info.index.has_value()) {
+            captures.indexed.emplace(info.index.value(), capture);
+        }
+        if (info.name.has_value()) {
+            captures.named.emplace(info.name.value(), capture);
+        }
+    }
+    return captures;
+}
+
+}  // namespace wr22::regex_executor::program
@@ -0,0 +1,188 @@
+// wr22
+#include <wr22/regex_executor/program/run_length.hpp>
+
+// stl
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define WR22_REGEX_EXECUTOR_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace wr22::regex_executor::program {
+
+namespace {
+    using Range = CompiledCharClass::Range;
+
+    /// Classes with more ranges are looked up in the bitmap of `CompiledCharClass` rather than
+    /// compared range by range.
+    constexpr size_t max_simd_ranges = 8;
+
+    bool in_ranges(char32_t c, std::span<const Range> ranges) {
+        return std::any_of(ranges.begin(), ranges.end(), [c](const Range& range) {
+            return c >= range.first && c <= range.last;
+        });
+    }
+
+    size_t scalar_run_length(
+        std::u32string_view string,
+        std::span<const Range> ranges,
+        size_t from) {
+        auto it = std::find_if(string.begin() + from, string.end(), [ranges](char32_t c) {
+            return !in_ranges(c, ranges);
+        });
+        return static_cast<size_t>(it - string.begin());
+    }
+
+#ifdef WR22_REGEX_EXECUTOR_X86_SIMD
+    // The vector instructions only compare signed integers. A character lies in a range if its
+    // offset from the first character of the range is at most the width of the range as
+    // unsigned numbers, so both sides have their sign bits flipped before being compared.
+    int flip_sign(uint32_t value) {
+        return static_cast<int>(value ^ 0x80000000u);
+    }
+
+    size_t sse2_run_length(std::u32string_view string, std::span<const Range> ranges) {
+        __m128i firsts[max_simd_ranges];
+        __m128i widths[max_simd_ranges];
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            firsts[i] = _mm_set1_epi32(static_cast<int>(ranges[i].first));
+            widths[i] = _mm_set1_epi32(flip_sign(ranges[i].last - ranges[i].first));
+        }
+        auto sign = _mm_set1_epi32(flip_sign(0));
+
+        auto pos = size_t(0);
+        for (; pos + 4 <= string.size(); pos += 4) {
+            auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(string.data() + pos));
+            auto outside = _mm_set1_epi32(-1);
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                auto offsets = _mm_xor_si128(_mm_sub_epi32(chars, firsts[i]), sign);
+                outside = _mm_and_si128(outside, _mm_cmpgt_epi32(offsets, widths[i]));
+            }
+            auto mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(outside)));
+            if (mask != 0) {
+                return pos + std::countr_zero(mask);
+            }
+        }
+        return scalar_run_length(string, ranges, pos);
+    }
+
+    __attribute__((target("avx2"))) size_t avx2_run_length(
+        std::u32string_view string,
+        std::span<const Range> ranges) {
+        __m256i firsts[max_simd_ranges];
+        __m256i widths[max_simd_ranges];
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            firsts[i] = _mm256_set1_epi32(static_cast<int>(ranges[i].first));
+            widths[i] = _mm256_set1_epi32(flip_sign(ranges[i].last - ranges[i].first));
+        }
+        auto sign = _mm256_set1_epi32(flip_sign(0));
+
+        auto pos = size_t(0);
+        for (; pos + 8 <= string.size(); pos += 8) {
+            auto chars =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(string.data() + pos));
+            auto outside = _mm256_set1_epi32(-1);
+            for (size_t i = 0; i < ranges.size(); ++i) {
+                auto offsets = _mm256_xor_si256(_mm256_sub_epi32(chars, firsts[i]), sign);
+                outside = _mm256_and_si256(outside, _mm256_cmpgt_epi32(offsets, widths[i]));
+            }
+            auto mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(outside)));
+            if (mask != 0) {
+                return pos + std::countr_zero(mask);
+            }
+        }
+        return scalar_run_length(string, ranges, pos);
+    }
+#endif
+
+    SimdLevel detect_simd_level() {
+#ifdef WR22_REGEX_EXECUTOR_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::Avx2;
+        }
+        // SSE2 is a part of x86-64.
+        return SimdLevel::Sse2;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+}  // namespace
+
+SimdLevel supported_simd_level() {
+    static const auto level = detect_simd_level();
+    return level;
+}
+
+size_t ranges_run_length(
+    std::u32string_view string,
+    std::span<const CompiledCharClass::Range> ranges,
+    SimdLevel level) {
+    if (ranges.size() > max_simd_ranges) {
+        level = SimdLevel::Scalar;
+    }
+#ifdef WR22_REGEX_EXECUTOR_X86_SIMD
+    if (level == SimdLevel::Avx2) {
+        return avx2_run_length(string, ranges);
+    }
+    if (level == SimdLevel::Sse2) {
+        return sse2_run_length(string, ranges);
+    }
+#endif
+    return scalar_run_length(string, ranges, 0);
+}
+
+size_t literal_run_length(std::u32string_view string, char32_t c) {
+    auto range = Range{.first = c, .last = c};
+    return ranges_run_length(string, std::span(&range, 1));
+}
+
+size_t find_literal(std::u32string_view string, std::u32string_view literal, size_t from) {
+    if (from > string.size() || literal.size() > string.size() - from) {
+        return std::u32string_view::npos;
+    }
+    if (literal.empty()) {
+        return from;
+    }
+    // The characters other than the first one of the literal.
+    auto first = literal.front();
+    Range others[2];
+    auto num_others = size_t(0);
+    if (first != 0) {
+        others[num_others++] = Range{.first = 0, .last = first - 1};
+    }
+    if (first != 0xffffffff) {
+        others[num_others++] = Range{.first = first + 1, .last = 0xffffffff};
+    }
+
+    // The positions where the literal may start.
+    auto candidates = string.substr(0, string.size() - literal.size() + 1);
+    auto level = supported_simd_level();
+    while (from < candidates.size()) {
+        from += ranges_run_length(candidates.substr(from), std::span(others, num_others), level);
+        if (from == candidates.size()) {
+            break;
+        }
+        if (string.substr(from, literal.size()) == literal) {
+            return from;
+        }
+        ++from;
+    }
+    return std::u32string_view::npos;
+}
+
+size_t class_run_length(std::u32string_view string, const CompiledCharClass& char_class) {
+    const auto& ranges = char_class.ranges();
+    if (ranges.size() <= max_simd_ranges && supported_simd_level() != SimdLevel::Scalar) {
+        return ranges_run_length(string, ranges);
+    }
+    auto it = std::find_if(string.begin(), string.end(), [&char_class](char32_t c) {
+        return !char_class.matches(c);
+    });
+    return static_cast<size_t>(it - string.begin());
+}
+
+}  // namespace wr22::regex_executor::program
@@ -0,0 +1,94 @@
+// wr22
+#include <wr22/regex_executor/program/instruction.hpp>
+#include <wr22/regex_executor/program/run_length.hpp>
+#include <wr22/regex_executor/program/start_filter.hpp>
+
+// stl
+#include <algorithm>
+#include <utility>
+
+namespace wr22::regex_executor::program {
+
+StartFilter::StartFilter(const Program& program, std::u32string prefix)
+    : m_prefix(std::move(prefix)) {
+    auto visited = std::vector<bool>(program.instructions.size());
+    auto stack = std::vector<size_t>{0};
+    while (!stack.empty()) {
+        auto pc = stack.back();
+        stack.pop_back();
+        if (visited.at(pc)) {
+            continue;
+        }
+        visited.at(pc) = true;
+        program.instructions.at(pc).visit(
+            [&stack](const instruction::Alternatives& instruction) {
+                stack.insert(stack.end(), instruction.targets.begin(), instruction.targets.end());
+            },
+            [&stack](const instruction::FinishAlternative& instruction) {
+                stack.push_back(instruction.target);
+            },
+            [&stack](const instruction::QuantifierSplit& instruction) {
+                stack.push_back(instruction.body);
+                stack.push_back(instruction.exit);
+            },
+            [&stack](const instruction::EndIteration& instruction) {
+                stack.push_back(instruction.target);
+            },
+            [this]([[maybe_unused]] const instruction::Match& instruction) {
+                m_matches_empty = true;
+            },
+            [this, pc]([[maybe_unused]] const instruction::Literal& instruction) {
+                m_start_pcs.push_back(pc);
+            },
+            [this, pc]([[maybe_unused]] const instruction::Wildcard& instruction) {
+                m_start_pcs.push_back(pc);
+            },
+            [this, pc]([[maybe_unused]] const instruction::CharClass& instruction) {
+                m_start_pcs.push_back(pc);
+            },
+            [&stack, pc]([[maybe_unused]] const auto& instruction) {
+                // Groups and quantifier bounds: continue with the next instruction.
+                stack.push_back(pc + 1);
+            });
+    }
+
+    for (char32_t c = 0; c < m_ascii.size(); ++c) {
+        m_ascii[c] = std::any_of(m_start_pcs.begin(), m_start_pcs.end(), [&program, c](size_t pc) {
+            return consumes(program, pc, c);
+        });
+    }
+}
+
+bool StartFilter::matches_empty() const {
+    return m_matches_empty;
+}
+
+std::optional<size_t> StartFilter::next_candidate(
+    const Program& program,
+    std::u32string_view string,
+    size_t from) const {
+    if (m_matches_empty) {
+        return from <= string.size() ? std::optional(from) : std::nullopt;
+    }
+    if (!m_prefix.empty()) {
+        auto pos = find_literal(string, m_prefix, from);
+        return pos != std::u32string_view::npos ? std::optional(pos) : std::nullopt;
+    }
+    for (auto pos = from; pos < string.size(); ++pos) {
+        if (can_start_with(program, string[pos])) {
+            return pos;
+        }
+    }
+    return std::nullopt;
+}
+
+bool StartFilter::can_start_with(const Program& program, char32_t c) const {
+    if (c < m_ascii.size()) {
+        return m_ascii[c];
+    }
+    return std::any_of(m_start_pcs.begin(), m_start_pcs.end(), [&program, c](size_t pc) {
+        return consumes(program, pc, c);
+    });
+}
+
+}  // namespace wr22::regex_executor::program
@@ -0,0 +1,26 @@
+// wr22
+#include <wr22/regex_executor/quantifier_type.hpp>
+
+namespace wr22::regex_executor {
+
+size_t min_repetitions(QuantifierType type) {
+    switch (type) {
+    case QuantifierType::Optional:
+    case QuantifierType::Star:
+        return 0;
+    case QuantifierType::Plus:
+        return 1;
+    }
+}
+
+std::optional<size_t> max_repetitions(QuantifierType type) {
+    switch (type) {
+    case QuantifierType::Optional:
+        return 1;
+    case QuantifierType::Star:
+    case QuantifierType::Plus:
+        return std::nullopt;
+    }
+}
+
+}  // namespace wr22::regex_executor
@@ -1,12 +1,38 @@
 // wr22
+#include <wr22/regex_executor/program/compiler.hpp>
 #include <wr22/regex_executor/regex.hpp>
 
 namespace wr22::regex_executor {
 
-Regex::Regex(regex_parser::regex::SpannedPart root_part) : m_root_part(std::move(root_part)) {}
+Regex::Regex(regex_parser::regex::SpannedPart root_part)
+    : m_root_part(std::move(root_part)), m_program(program::compile(m_root_part)),
+      m_prefilter(m_root_part), m_start_filter(m_program, m_prefilter.prefix()),
+      m_one_pass_automaton(algorithms::one_pass::Automaton::build(m_program)),
+      m_bit_parallel_automaton(algorithms::bit_parallel::PositionAutomaton::build(m_root_part)) {}
 
 const regex_parser::regex::SpannedPart& Regex::root_part() const {
     return m_root_part;
 }
 
+const program::Program& Regex::program() const {
+    return m_program;
+}
+
+const Prefilter& Regex::prefilter() const {
+    return m_prefilter;
+}
+
+const program::StartFilter& Regex::start_filter() const {
+    return m_start_filter;
+}
+
+const std::optional<algorithms::one_pass::Automaton>& Regex::one_pass_automaton() const {
+    return m_one_pass_automaton;
+}
+
+const std::optional<algorithms::bit_parallel::PositionAutomaton>& Regex::bit_parallel_automaton()
+    const {
+    return m_bit_parallel_automaton;
+}
+
 }  // namespace wr22::regex_executor
@@ -0,0 +1,73 @@
+// wr22
+#include <wr22/regex_executor/regex_set.hpp>
+
+// stl
+#include <algorithm>
+#include <utility>
+
+namespace wr22::regex_executor {
+
+namespace {
+    std::vector<Regex> compile_all(std::vector<regex_parser::regex::SpannedPart> root_parts) {
+        auto regexes = std::vector<Regex>();
+        regexes.reserve(root_parts.size());
+        for (auto& root_part : root_parts) {
+            regexes.emplace_back(std::move(root_part));
+        }
+        return regexes;
+    }
+
+    std::vector<size_t> program_offsets_of(const std::vector<Regex>& regexes) {
+        auto offsets = std::vector<size_t>{0};
+        for (const auto& regex : regexes) {
+            offsets.push_back(offsets.back() + regex.program().instructions.size());
+        }
+        return offsets;
+    }
+
+    algorithms::lazy_dfa::Alphabet alphabet_of(const std::vector<Regex>& regexes) {
+        auto programs = std::vector<const program::Program*>();
+        for (const auto& regex : regexes) {
+            programs.push_back(&regex.program());
+        }
+        return algorithms::lazy_dfa::Alphabet(programs);
+    }
+}  // namespace
+
+RegexSet::RegexSet(std::vector<regex_parser::regex::SpannedPart> root_parts)
+    : m_regexes(compile_all(std::move(root_parts))),
+      m_program_offsets(program_offsets_of(m_regexes)), m_alphabet(alphabet_of(m_regexes)) {}
+
+size_t RegexSet::size() const {
+    return m_regexes.size();
+}
+
+const Regex& RegexSet::regex_at(size_t regex_index) const {
+    return m_regexes.at(regex_index);
+}
+
+const std::vector<Regex>& RegexSet::regexes() const {
+    return m_regexes;
+}
+
+size_t RegexSet::num_instructions() const {
+    return m_program_offsets.back();
+}
+
+size_t RegexSet::program_offset(size_t regex_index) const {
+    return m_program_offsets.at(regex_index);
+}
+
+size_t RegexSet::regex_index_of(size_t instruction_number) const {
+    auto it = std::upper_bound(
+        m_program_offsets.begin(),
+        m_program_offsets.end(),
+        instruction_number);
+    return static_cast<size_t>(it - m_program_offsets.begin()) - 1;
+}
+
+const algorithms::lazy_dfa::Alphabet& RegexSet::alphabet() const {
+    return m_alphabet;
+}
+
+}  // namespace wr22::regex_executor
@@ -0,0 +1,51 @@
+// wr22
+#include <wr22/regex_executor/executor.hpp>
+#include <wr22/regex_executor/match_options.hpp>
+#include <wr22/regex_executor/set_executor.hpp>
+
+// stl
+#include <utility>
+
+namespace wr22::regex_executor {
+
+SetExecutor::SetExecutor(const RegexSet& regex_set_ref)
+    : m_lazy_dfa_executor(regex_set_ref, Fragment::Whole),
+      m_lazy_dfa_search_executor(regex_set_ref, Fragment::Search) {}
+
+const RegexSet& SetExecutor::regex_set_ref() const {
+    return m_lazy_dfa_executor.regex_set_ref();
+}
+
+SetMatchResult SetExecutor::execute(
+    const std::u32string_view& string,
+    Fragment fragment,
+    const MatchBudget& budget) {
+    auto& lazy_dfa_executor =
+        fragment == Fragment::Whole ? m_lazy_dfa_executor : m_lazy_dfa_search_executor;
+    if (auto result = lazy_dfa_executor.execute(string); result.has_value()) {
+        return SetMatchResult{
+            .matched = std::move(result.value().matched),
+            .combined = true,
+        };
+    }
+
+    // The combined DFA state cache thrashes: match the regexes one by one, letting the planner
+    // pick the fastest algorithm for a verdict.
+    auto options = MatchOptions{
+        .record_steps = false,
+        .record_captures = false,
+        .fragment = fragment == Fragment::Whole ? Fragment::Whole : Fragment::Search,
+        .budget = budget,
+    };
+    auto result = SetMatchResult{.combined = false};
+    const auto& regexes = regex_set_ref().regexes();
+    for (size_t regex_index = 0; regex_index < regexes.size(); ++regex_index) {
+        auto executor = Executor(regexes[regex_index]);
+        if (executor.execute(string, options).matched) {
+            result.matched.push_back(regex_index);
+        }
+    }
+    return result;
+}
+
+}  // namespace wr22::regex_executor
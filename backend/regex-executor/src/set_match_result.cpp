@@ -0,0 +1,15 @@
+// wr22
+#include <wr22/regex_executor/set_match_result.hpp>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+namespace wr22::regex_executor {
+
+void to_json(nlohmann::json& j, const SetMatchResult& result) {
+    j = nlohmann::json::object();
+    j["matched_regexes"] = result.matched;
+    j["combined"] = result.combined;
+}
+
+}  // namespace wr22::regex_executor
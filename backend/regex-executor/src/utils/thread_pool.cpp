@@ -0,0 +1,105 @@
+// wr22
+#include <wr22/regex_executor/utils/thread_pool.hpp>
+
+// stl
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace wr22::regex_executor::utils {
+
+namespace {
+    /// The calls of the task made on behalf of a single `ThreadPool::run`.
+    struct Job {
+        const std::function<void(size_t)>& task;
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t num_running = 0;
+        /// Set when the calling thread has done its part; the calls that start later are
+        /// skipped, since the task may not exist anymore.
+        bool closed = false;
+    };
+}  // namespace
+
+ThreadPool::ThreadPool(size_t num_threads) : m_num_threads(num_threads) {}
+
+ThreadPool::~ThreadPool() {
+    {
+        auto lock = std::lock_guard(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeup.notify_all();
+    // Join the threads while the queue and the mutex still exist.
+    m_threads.clear();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static auto pool = ThreadPool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
+size_t ThreadPool::num_threads() const {
+    return m_num_threads;
+}
+
+void ThreadPool::run(size_t num_helpers, const std::function<void(size_t)>& task) {
+    auto job = std::make_shared<Job>(task);
+    num_helpers = std::min(num_helpers, m_num_threads);
+    if (num_helpers > 0) {
+        {
+            auto lock = std::lock_guard(m_mutex);
+            start_threads();
+            for (size_t i = 1; i <= num_helpers; ++i) {
+                m_queue.push_back([job, i] {
+                    {
+                        auto job_lock = std::lock_guard(job->mutex);
+                        if (job->closed) {
+                            return;
+                        }
+                        ++job->num_running;
+                    }
+                    job->task(i);
+                    {
+                        auto job_lock = std::lock_guard(job->mutex);
+                        --job->num_running;
+                    }
+                    job->done.notify_all();
+                });
+            }
+        }
+        m_wakeup.notify_all();
+    }
+
+    task(0);
+    auto job_lock = std::unique_lock(job->mutex);
+    job->closed = true;
+    job->done.wait(job_lock, [&job] { return job->num_running == 0; });
+}
+
+void ThreadPool::start_threads() {
+    if (!m_threads.empty()) {
+        return;
+    }
+    m_threads.reserve(m_num_threads);
+    for (size_t i = 0; i < m_num_threads; ++i) {
+        m_threads.emplace_back([this] { work(); });
+    }
+}
+
+void ThreadPool::work() {
+    while (true) {
+        auto item = std::function<void()>();
+        {
+            auto lock = std::unique_lock(m_mutex);
+            m_wakeup.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            item = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        item();
+    }
+}
+
+}  // namespace wr22::regex_executor::utils
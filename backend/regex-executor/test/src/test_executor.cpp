@@ -2,14 +2,60 @@
 #include <catch2/catch.hpp>
 
 // wr22
+#include <wr22/regex_executor/algorithms/backtracking/step_log.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step_sink.hpp>
 #include <wr22/regex_executor/executor.hpp>
+#include <wr22/regex_executor/program/run_length.hpp>
 #include <wr22/regex_executor/regex.hpp>
+#include <wr22/regex_executor/regex_set.hpp>
+#include <wr22/regex_executor/set_executor.hpp>
 #include <wr22/regex_parser/parser/regex.hpp>
 
+// stl
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// nlohmann
+#include <nlohmann/json.hpp>
+
+using wr22::regex_executor::Algorithm;
+using wr22::regex_executor::BudgetExceeded;
 using wr22::regex_executor::Capture;
 using wr22::regex_executor::Captures;
 using wr22::regex_executor::Executor;
+using wr22::regex_executor::Fragment;
+using wr22::regex_executor::MatchBudget;
+using wr22::regex_executor::MatchOptions;
+using wr22::regex_executor::Planner;
+using wr22::regex_executor::Prefilter;
+using wr22::regex_executor::RegexProfile;
 using wr22::regex_executor::Regex;
+using wr22::regex_executor::RegexSet;
+using wr22::regex_executor::SetExecutor;
+using wr22::regex_executor::algorithms::backtracking::CountingStepSink;
+using wr22::regex_executor::algorithms::backtracking::JsonStepSink;
+using wr22::regex_executor::algorithms::backtracking::Step;
+using wr22::regex_executor::algorithms::backtracking::StepLog;
+using wr22::regex_executor::algorithms::backtracking::VectorStepSink;
+using LazyDfaExecutor = wr22::regex_executor::algorithms::lazy_dfa::Executor;
+using LazyDfaSetExecutor = wr22::regex_executor::algorithms::lazy_dfa::SetExecutor;
+using ParallelLazyDfaExecutor = wr22::regex_executor::algorithms::lazy_dfa::ParallelExecutor;
+using wr22::regex_executor::program::class_run_length;
+using wr22::regex_executor::program::CompiledCharClass;
+using wr22::regex_executor::program::find_literal;
+using wr22::regex_executor::program::literal_run_length;
+using wr22::regex_executor::program::ranges_run_length;
+using wr22::regex_executor::program::SimdLevel;
+using wr22::regex_executor::program::supported_simd_level;
 using wr22::regex_parser::parser::parse_regex;
 using wr22::regex_parser::span::Span;
 
@@ -193,6 +239,23 @@ TEST_CASE("Repeated group captures by index work") {
         });
 }
 
+TEST_CASE("Groups are numbered in the order of their opening parentheses") {
+    auto regex = Regex(parse_regex(U"((a)|(b))+"));
+    auto ex = Executor(regex);
+    CHECK(
+        ex.execute(U"abba").captures.value()
+        == Captures{
+            .whole = Capture{.string_span = Span::make_with_length(0, 4)},
+            .indexed =
+                {
+                    {1, Capture{.string_span = Span::make_with_length(3, 1)}},
+                    {2, Capture{.string_span = Span::make_with_length(3, 1)}},
+                    {3, Capture{.string_span = Span::make_with_length(2, 1)}},
+                },
+            .named = {},
+        });
+}
+
 TEST_CASE("Repeated group captures by name work") {
     auto regex = Regex(parse_regex(U"(?P<foo>.)*"));
     auto ex = Executor(regex);
@@ -208,6 +271,32 @@ TEST_CASE("Repeated group captures by name work") {
         });
 }
 
+TEST_CASE("Groups sharing a name capture into the same slot") {
+    auto regex = Regex(parse_regex(U"(?P<x>a)(?P<x>b)|(?P<x>c)d"));
+    auto ex = Executor(regex);
+    auto expected_ab = Captures{
+        .whole = Capture{.string_span = Span::make_with_length(0, 2)},
+        .indexed = {},
+        .named =
+            {
+                {"x", Capture{.string_span = Span::make_with_length(1, 1)}},
+            },
+    };
+    auto expected_cd = Captures{
+        .whole = Capture{.string_span = Span::make_with_length(0, 2)},
+        .indexed = {},
+        .named =
+            {
+                {"x", Capture{.string_span = Span::make_with_length(0, 1)}},
+            },
+    };
+    for (auto algorithm : {Algorithm::Backtracking, Algorithm::PikeVm}) {
+        auto options = MatchOptions{.algorithm = algorithm};
+        CHECK(ex.execute(U"ab", options).captures.value() == expected_ab);
+        CHECK(ex.execute(U"cd", options).captures.value() == expected_cd);
+    }
+}
+
 TEST_CASE("Empty group under an unbounded quantifier works") {
     auto regex = Regex(parse_regex(U"(?:)*"));
     auto ex = Executor(regex);
@@ -231,3 +320,946 @@ TEST_CASE("Empty optional under an unbounded quantifier works") {
     CHECK_FALSE(ex.execute(U"aaa").matched);
     CHECK_FALSE(ex.execute(U"").matched);
 }
+
+TEST_CASE("Character classes with overlapping and inverted ranges work") {
+    auto regex = Regex(parse_regex(U"[d-fa-ec-gz]+[^а-гв-еx]"));
+    auto ex = Executor(regex);
+    CHECK(ex.execute(U"abcdefgzy").matched);
+    CHECK(ex.execute(U"gж").matched);
+    CHECK(ex.execute(U"g€").matched);
+    CHECK_FALSE(ex.execute(U"hy").matched);
+    CHECK_FALSE(ex.execute(U"gд").matched);
+    CHECK_FALSE(ex.execute(U"gа").matched);
+    CHECK_FALSE(ex.execute(U"gx").matched);
+}
+
+TEST_CASE("Matching without recording steps gives the same verdict and captures") {
+    auto regex = Regex(parse_regex(U"a(?P<mid>b|bbc)*(c+)d"));
+    auto ex = Executor(regex);
+    auto options = MatchOptions{.record_steps = false};
+    for (auto string : {U"abbccd", U"abcd", U"acd", U"abbd", U"ad"}) {
+        auto traced = ex.execute(string);
+        auto untraced = ex.execute(string, options);
+        CHECK(traced.steps.has_value());
+        CHECK_FALSE(untraced.steps.has_value());
+        CHECK(traced.matched == untraced.matched);
+        CHECK(traced.captures == untraced.captures);
+    }
+}
+
+TEST_CASE("Step sinks receive the steps as they are recorded") {
+    auto regex = Regex(parse_regex(U"a(?P<mid>b|bbc)*(c+)d"));
+    auto ex = Executor(regex);
+    for (auto string : {U"abbccd", U"abbd"}) {
+        auto expected = ex.execute(string);
+        auto options = MatchOptions{.record_steps = false};
+
+        auto vector_sink = VectorStepSink();
+        auto result = ex.execute(string, options, vector_sink);
+        CHECK(result.matched == expected.matched);
+        CHECK(result.captures == expected.captures);
+        CHECK_FALSE(result.steps.has_value());
+        CHECK(vector_sink.steps() == expected.steps.value());
+
+        auto counting_sink = CountingStepSink();
+        ex.execute(string, options, counting_sink);
+        CHECK(counting_sink.num_steps() == expected.steps.value().size());
+
+        auto out = std::ostringstream();
+        auto json_sink = JsonStepSink(out);
+        ex.execute(string, options, json_sink);
+        json_sink.finish();
+        CHECK(nlohmann::json::parse(out.str()) == nlohmann::json(expected.steps.value()));
+    }
+}
+
+TEST_CASE("Step log expands into the steps it has recorded") {
+    auto regex = Regex(parse_regex(U"(?:a(?P<mid>b|bbc)*(c+)[d-e].?)+"));
+    auto ex = Executor(regex);
+    for (auto string : {U"abbccdx", U"abbd", U"acdacex", U""}) {
+        auto expected = ex.execute(string);
+        auto step_log = StepLog();
+        ex.execute(string, MatchOptions{.record_steps = false}, step_log);
+        CHECK(step_log.size() == expected.steps.value().size());
+        CHECK(step_log.to_steps() == expected.steps.value());
+        CHECK(nlohmann::json(step_log) == nlohmann::json(expected.steps.value()));
+        CHECK(step_log.memory_usage() < expected.steps.value().size() * sizeof(Step));
+    }
+}
+
+namespace {
+    const auto cross_check_cases = std::vector<std::pair<std::u32string, std::u32string>>{
+        {U"(.*)ll", U"ball"},
+        {U"(.*)ll", U"ballpark"},
+        {U"a(?:b+c)+d", U"abbcbcd"},
+        {U"a(?P<mid>b|bbc)*(c+)d", U"abbccd"},
+        {U"(a|ab)(c|bcd)(d*)", U"abcd"},
+        {U"((a)|(b))+", U"abba"},
+        {U"(?:a?)*b", U"aaab"},
+        {U"(?:a?)*b", U"aaa"},
+        {U"[^a-c]+[0-9]?", U"xyz1"},
+        {U"[^a-c]+[0-9]?", U"xyzc"},
+        {U"(?:)*", U"a"},
+        {U"ж+.", U"жжж"},
+    };
+}  // namespace
+
+TEST_CASE("Pike VM gives the same verdict and captures as backtracking") {
+    auto options = MatchOptions{.algorithm = Algorithm::PikeVm};
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        auto expected = ex.execute(string);
+        auto actual = ex.execute(string, options);
+        CHECK(actual.algorithm == Algorithm::PikeVm);
+        CHECK_FALSE(actual.steps.has_value());
+        CHECK(actual.matched == expected.matched);
+        CHECK(actual.captures == expected.captures);
+    }
+}
+
+TEST_CASE("Lazy DFA gives the same verdict as backtracking") {
+    auto options = MatchOptions{.algorithm = Algorithm::LazyDfa};
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        auto expected = ex.execute(string);
+        auto actual = ex.execute(string, options);
+        CHECK(actual.algorithm == Algorithm::LazyDfa);
+        CHECK_FALSE(actual.captures.has_value());
+        CHECK(actual.matched == expected.matched);
+    }
+}
+
+TEST_CASE("Bit-parallel algorithm gives the same verdict as backtracking") {
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+            auto padded = fragment == Fragment::Search ? U"xy" + string + U"x" : string;
+            auto expected = ex.execute(padded, MatchOptions{.fragment = fragment});
+            auto actual = ex.execute(
+                padded,
+                MatchOptions{.fragment = fragment, .algorithm = Algorithm::BitParallel});
+            CHECK(actual.algorithm == Algorithm::BitParallel);
+            CHECK_FALSE(actual.captures.has_value());
+            CHECK(actual.matched == expected.matched);
+        }
+    }
+}
+
+TEST_CASE("Bit-parallel algorithm falls back to the lazy DFA for long regexes") {
+    auto options = MatchOptions{.algorithm = Algorithm::BitParallel};
+    auto short_regex = Regex(parse_regex(U"(?:ab|[c-e]." + std::u32string(59, U'x') + U")+"));
+    CHECK(short_regex.bit_parallel_automaton());
+    auto short_result = Executor(short_regex).execute(U"abab", options);
+    CHECK(short_result.algorithm == Algorithm::BitParallel);
+    CHECK(short_result.matched);
+
+    auto long_regex = Regex(parse_regex(U"(?:ab|[c-e]." + std::u32string(60, U'x') + U")+"));
+    CHECK_FALSE(long_regex.bit_parallel_automaton());
+    auto long_result = Executor(long_regex).execute(U"abab", options);
+    CHECK(long_result.algorithm == Algorithm::LazyDfa);
+    CHECK(long_result.matched);
+}
+
+TEST_CASE("One-pass regexes are detected") {
+    CHECK(Regex(parse_regex(U"(?P<key>[a-z]+)=(?P<value>[0-9]+)")).one_pass_automaton());
+    CHECK(Regex(parse_regex(U"a(?:b+c)+d")).one_pass_automaton());
+    CHECK_FALSE(Regex(parse_regex(U"(a|ab)(c|bcd)(d*)")).one_pass_automaton());
+    CHECK_FALSE(Regex(parse_regex(U"(.*)ll")).one_pass_automaton());
+    // An iteration can match the empty string.
+    CHECK_FALSE(Regex(parse_regex(U"(?:a?)*b")).one_pass_automaton());
+}
+
+TEST_CASE("One-pass DFA gives the same verdict and captures as backtracking") {
+    auto options = MatchOptions{.algorithm = Algorithm::OnePass};
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        auto expected = ex.execute(string);
+        auto actual = ex.execute(string, options);
+        CHECK(
+            actual.algorithm
+            == (regex.one_pass_automaton() ? Algorithm::OnePass : Algorithm::PikeVm));
+        CHECK(actual.matched == expected.matched);
+        CHECK(actual.captures == expected.captures);
+    }
+}
+
+TEST_CASE("One-pass DFA is planned when no steps are recorded") {
+    auto regex = Regex(parse_regex(U"(?P<key>[a-z]+)=(?P<value>[0-9]+)"));
+    auto ex = Executor(regex);
+    for (auto string : {U"key=123", U"key=", U"=1", U"key=12x"}) {
+        auto expected = ex.execute(string);
+        auto actual = ex.execute(string, MatchOptions{.record_steps = false});
+        CHECK(actual.algorithm == Algorithm::OnePass);
+        CHECK(actual.matched == expected.matched);
+        CHECK(actual.captures == expected.captures);
+    }
+    auto search = ex.execute(
+        U"a key=1",
+        MatchOptions{.record_steps = false, .fragment = Fragment::Search});
+    CHECK(search.algorithm == Algorithm::Backtracking);
+}
+
+TEST_CASE("Planner profiles regexes") {
+    auto profile = [](const std::u32string& pattern) {
+        return RegexProfile::of(Regex(parse_regex(pattern)));
+    };
+    CHECK(profile(U"(x+x+)+y").backtracking_risk);
+    CHECK(profile(U"(?:a|ab)*c").backtracking_risk);
+    CHECK(profile(U"[a-z]*[a-z0-9]+").backtracking_risk);
+    CHECK_FALSE(profile(U"[a-z]+=[a-z]+").backtracking_risk);
+    CHECK_FALSE(profile(U"(?:a|b)*c").backtracking_risk);
+    CHECK(profile(U"f(o)o").literal);
+    CHECK_FALSE(profile(U"fo+").literal);
+    CHECK(profile(U"(?:a?)*b").empty_iterations);
+    CHECK(profile(U"(a)(b)").num_capture_slots == 2);
+}
+
+TEST_CASE("Planner picks the fastest algorithm that gives what is asked for") {
+    auto algorithm_for = [](const std::u32string& pattern,
+                            const std::u32string& string,
+                            MatchOptions options) {
+        auto regex = Regex(parse_regex(pattern));
+        return Executor(regex).execute(string, options).algorithm;
+    };
+    auto no_steps = MatchOptions{.record_steps = false};
+    auto verdict = MatchOptions{.record_steps = false, .record_captures = false};
+    auto search = MatchOptions{.record_steps = false, .fragment = Fragment::Search};
+
+    CHECK(algorithm_for(U"(x+x+)+y", U"xxy", {}) == Algorithm::Backtracking);
+    CHECK(algorithm_for(U"(x+x+)+y", U"xxy", verdict) == Algorithm::BitParallel);
+    CHECK(algorithm_for(U"[a-z]+=[0-9]+", U"a=1", no_steps) == Algorithm::OnePass);
+    CHECK(algorithm_for(U"(x+x+)+y", U"xxy", no_steps) == Algorithm::PikeVm);
+    CHECK(algorithm_for(U"(a+)(b+)(c+)(d+)+", U"abcd", search) == Algorithm::Backtracking);
+    CHECK(algorithm_for(U"(?:a|b)*c", U"abc", search) == Algorithm::Backtracking);
+    auto long_string = std::u32string(Planner::long_string, U'a') + U"c";
+    CHECK(algorithm_for(U"(?:a|b)*c", long_string, search) == Algorithm::PikeVm);
+    CHECK(algorithm_for(U"abc", long_string, search) == Algorithm::Backtracking);
+
+    // Catastrophic regexes are never matched by plain backtracking.
+    for (const auto& pattern :
+         {U"(x+x+)+y", U"(?:a|ab)*c", U"[a-z]*[a-z0-9]+", U"(a*)*b", U"(?:a|a?)+b"}) {
+        auto regex = Regex(parse_regex(pattern));
+        auto planner = Planner(regex);
+        for (auto length : {size_t(20), Planner::max_memoization_bits}) {
+            auto planned = planner.plan(no_steps, length);
+            CHECK((planned.algorithm == Algorithm::PikeVm || planned.memoize));
+        }
+    }
+    // The captures of empty iterations are left to backtracking when it is safe.
+    auto empty_iterations = Planner(Regex(parse_regex(U"(|a)+"))).plan(no_steps, 20);
+    CHECK(empty_iterations.algorithm == Algorithm::Backtracking);
+    CHECK_FALSE(empty_iterations.memoize);
+    auto risky_empty_iterations = Planner(Regex(parse_regex(U"(a*)*b"))).plan(no_steps, 20);
+    CHECK(risky_empty_iterations.algorithm == Algorithm::Backtracking);
+    CHECK(risky_empty_iterations.memoize);
+
+    // A forced algorithm is respected.
+    auto forced = MatchOptions{.record_steps = false, .algorithm = Algorithm::Backtracking};
+    CHECK(algorithm_for(U"(x+x+)+y", U"xxy", forced) == Algorithm::Backtracking);
+}
+
+TEST_CASE("Planned algorithms give the same verdict and captures as backtracking") {
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+            auto expected = ex.execute(string, MatchOptions{.fragment = fragment});
+            auto actual =
+                ex.execute(string, MatchOptions{.record_steps = false, .fragment = fragment});
+            CHECK(actual.matched == expected.matched);
+            CHECK(actual.captures == expected.captures);
+        }
+    }
+}
+
+TEST_CASE("Lazy DFA gives up when its cache thrashes") {
+    auto regex = Regex(parse_regex(U"(?:a|b)*a(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)"));
+    auto ex = LazyDfaExecutor(regex, Fragment::Whole, 4096);
+    CHECK(ex.execute(U"abbbbbb").value().matched);
+    CHECK_FALSE(ex.execute(U"abbbbbbb").value().matched);
+
+    auto string = std::u32string();
+    auto seed = 12345u;
+    for (size_t i = 0; i < 10000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        string.push_back((seed >> 16) % 2 == 0 ? U'a' : U'b');
+    }
+    CHECK_FALSE(ex.execute(string).has_value());
+
+    // The top-level executor falls back to the Pike VM.
+    auto fallback = Executor(regex).execute(string, MatchOptions{.algorithm = Algorithm::LazyDfa});
+    CHECK(fallback.matched == (string[string.size() - 7] == U'a'));
+}
+
+TEST_CASE("Pike VM handles nested quantifiers in linear time") {
+    auto regex = Regex(parse_regex(U"(a*)*b"));
+    auto ex = Executor(regex);
+    auto options = MatchOptions{.algorithm = Algorithm::PikeVm};
+    auto string = std::u32string(100000, U'a');
+    CHECK_FALSE(ex.execute(string, options).matched);
+    string.push_back(U'b');
+    CHECK(ex.execute(string, options).matched);
+}
+
+TEST_CASE("Planned matches of empty iterations are the ones backtracking finds") {
+    auto spans = [](const std::vector<Captures>& matches) {
+        auto result = std::vector<Span>();
+        for (const auto& captures : matches) {
+            result.push_back(captures.whole.string_span);
+        }
+        return result;
+    };
+    for (const auto& pattern : {U"(|a)+", U"(?:(?:|a)+)a"}) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto record_steps : {false, true}) {
+            auto planned = MatchOptions{.record_steps = record_steps, .fragment = Fragment::Search};
+            auto forced = planned;
+            forced.algorithm = Algorithm::Backtracking;
+            auto expected = ex.execute(U"aaa", forced);
+            CHECK(expected.captures.value().whole.string_span == Span::make_from_positions(0, 3));
+            CHECK(ex.execute(U"aaa", planned).captures == expected.captures);
+            CHECK(
+                spans(ex.find_all(U"aaa", planned).matches.value())
+                == spans(ex.find_all(U"aaa", forced).matches.value()));
+        }
+    }
+
+    auto all = Executor(Regex(parse_regex(U"(|a)+")))
+                   .find_all(U"aaa", MatchOptions{.record_steps = false});
+    CHECK(
+        spans(all.matches.value())
+        == std::vector<Span>{Span::make_from_positions(0, 3), Span::make_empty(3)});
+}
+
+TEST_CASE("Nested quantifiers finish on long strings when no algorithm is forced") {
+    for (const auto& pattern : {U"(a*)*b", U"(?:a*)*b"}) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto length : {size_t(24), size_t(5000), size_t(100000)}) {
+            auto string = std::u32string(length, U'a') + U"c";
+            auto options = MatchOptions{
+                .record_steps = false,
+                .budget = MatchBudget{.max_steps = 100 * length},
+            };
+            CHECK_FALSE(ex.execute(string, options).matched);
+            options.fragment = Fragment::Search;
+            string += U"b";
+            auto result = ex.execute(string, options);
+            REQUIRE(result.captures.has_value());
+            CHECK(
+                result.captures.value().whole.string_span
+                == Span::make_single_position(length + 1));
+        }
+    }
+}
+
+TEST_CASE("Memoized backtracking gives the same verdict and captures") {
+    auto options = MatchOptions{.record_steps = false, .memoize = true};
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        auto expected = ex.execute(string);
+        auto actual = ex.execute(string, options);
+        CHECK(actual.algorithm == Algorithm::Backtracking);
+        CHECK(actual.matched == expected.matched);
+        CHECK(actual.captures == expected.captures);
+    }
+}
+
+TEST_CASE("Memoized backtracking handles catastrophic patterns") {
+    auto regex = Regex(parse_regex(U"(x+x+)+y"));
+    auto ex = Executor(regex);
+    auto options = MatchOptions{.memoize = true};
+    auto string = std::u32string(200, U'x');
+    auto result = ex.execute(string, options);
+    CHECK_FALSE(result.matched);
+    CHECK(result.steps.has_value());
+    string.push_back(U'y');
+    CHECK(ex.execute(string, options).matched);
+}
+
+TEST_CASE("Memoized backtracking finds the same matches with empty iterations") {
+    auto cases = std::vector<std::pair<std::u32string, std::u32string>>{
+        {U"(|a)+", U"aaa"},
+        {U"(?:(?:|a)+)a", U"aaa"},
+        {U"(?:(a|)*b)*", U"aabab"},
+        {U"(?:a?)*(?:|b)+c", U"abbc"},
+    };
+    for (const auto& [pattern, string] : cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+            auto plain = MatchOptions{
+                .record_steps = false,
+                .fragment = fragment,
+                .algorithm = Algorithm::Backtracking,
+            };
+            auto memoized = plain;
+            memoized.memoize = true;
+            auto expected = ex.execute(string, plain);
+            auto actual = ex.execute(string, memoized);
+            CHECK(actual.matched == expected.matched);
+            CHECK(actual.captures == expected.captures);
+            CHECK(ex.find_all(string, memoized).matches == ex.find_all(string, plain).matches);
+        }
+    }
+
+    auto regex = Regex(parse_regex(U"(|a)+"));
+    auto options = MatchOptions{
+        .record_steps = false,
+        .memoize = true,
+        .fragment = Fragment::Search,
+        .algorithm = Algorithm::Backtracking,
+    };
+    auto result = Executor(regex).execute(U"aaa", options);
+    CHECK(result.captures.value().whole.string_span == Span::make_from_positions(0, 3));
+}
+
+TEST_CASE("Search finds the leftmost match with every algorithm") {
+    auto regex = Regex(parse_regex(U"b(a+)|cd"));
+    auto ex = Executor(regex);
+    auto expected = Captures{
+        .whole = Capture{.string_span = Span::make_with_length(3, 3)},
+        .indexed = {{1, Capture{.string_span = Span::make_with_length(4, 2)}}},
+        .named = {},
+    };
+    CHECK_FALSE(ex.execute(U"xcxbaaycd").matched);
+    for (auto algorithm : {Algorithm::Backtracking, Algorithm::PikeVm, Algorithm::LazyDfa}) {
+        auto options = MatchOptions{.fragment = Fragment::Search, .algorithm = algorithm};
+        auto result = ex.execute(U"xcxbaaycd", options);
+        CHECK(result.matched);
+        if (algorithm != Algorithm::LazyDfa) {
+            CHECK(result.captures.value() == expected);
+        }
+        CHECK_FALSE(ex.execute(U"xcxbyc", options).matched);
+        CHECK_FALSE(ex.execute(U"", options).matched);
+    }
+}
+
+TEST_CASE("Search agrees across algorithms") {
+    auto search = MatchOptions{.record_steps = false, .fragment = Fragment::Search};
+    auto pike_vm = search;
+    pike_vm.algorithm = Algorithm::PikeVm;
+    auto lazy_dfa = search;
+    lazy_dfa.algorithm = Algorithm::LazyDfa;
+    for (const auto& [pattern, string] : cross_check_cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        auto padded = U"xy" + string + U"x";
+        auto expected = ex.execute(padded, search);
+        if (ex.execute(string).matched) {
+            CHECK(expected.matched);
+        }
+        CHECK(ex.execute(padded, pike_vm).captures == expected.captures);
+        CHECK(ex.execute(padded, lazy_dfa).matched == expected.matched);
+    }
+
+    // The empty match at the very start is the leftmost one.
+    auto regex = Regex(parse_regex(U"x*"));
+    auto result = Executor(regex).execute(U"abxx", search);
+    CHECK(result.captures.value().whole.string_span == Span::make_empty(0));
+}
+
+TEST_CASE("Find all returns every non-overlapping match") {
+    auto regex = Regex(parse_regex(U"(?P<word>[a-z]+)|x*"));
+    auto ex = Executor(regex);
+    auto word = [](size_t begin, size_t length) {
+        auto capture = Capture{.string_span = Span::make_with_length(begin, length)};
+        return Captures{.whole = capture, .indexed = {}, .named = {{"word", capture}}};
+    };
+    auto empty = [](size_t position) {
+        return Captures{.whole = Capture{.string_span = Span::make_empty(position)}};
+    };
+    auto expected = std::vector<Captures>{word(0, 2), empty(2), word(3, 3), empty(6)};
+
+    for (auto algorithm : {Algorithm::Backtracking, Algorithm::PikeVm, Algorithm::LazyDfa}) {
+        auto options = MatchOptions{.algorithm = algorithm};
+        auto result = ex.find_all(U"ab cde", options);
+        CHECK(result.matched);
+        CHECK(result.matches.value() == expected);
+        CHECK(result.captures.value() == expected.front());
+
+        options.memoize = true;
+        CHECK(ex.find_all(U"ab cde", options).matches.value() == expected);
+    }
+
+    auto none = Executor(Regex(parse_regex(U"y+"))).find_all(U"ab cde");
+    CHECK_FALSE(none.matched);
+    CHECK(none.matches.value().empty());
+}
+
+TEST_CASE("Prefilter extracts the literals every match contains") {
+    auto prefilter = [](const char32_t* pattern) { return Prefilter(parse_regex(pattern)); };
+    auto a = prefilter(U"GET /(?:index|home)[.]html");
+    CHECK(a.prefix() == U"GET /");
+    CHECK(a.suffix() == U".html");
+    CHECK(a.required() == U"GET /");
+
+    auto b = prefilter(U"[0-9]+ (?:error|fatal error): (.*)");
+    CHECK(b.prefix() == U"");
+    CHECK(b.suffix() == U"");
+    CHECK(b.required() == U"error: ");
+
+    auto c = prefilter(U"x(?:ab)+y|x(?:ab)*z");
+    CHECK(c.prefix() == U"x");
+    CHECK(c.required() == U"x");
+
+    auto d = prefilter(U"a?b*");
+    CHECK(d.required() == U"");
+    CHECK(d.may_match(U"", Fragment::Whole));
+}
+
+TEST_CASE("Strings without the required literals are rejected") {
+    auto regex = Regex(parse_regex(U"[a-z]+=(?:on|off)"));
+    auto ex = Executor(regex);
+    auto untraced = MatchOptions{.record_steps = false, .fragment = Fragment::Search};
+    CHECK_FALSE(regex.prefilter().may_match(U"key: on", Fragment::Search));
+    CHECK_FALSE(ex.execute(U"key: on", untraced).matched);
+    CHECK(ex.execute(U"; key=on", untraced).matched);
+
+    // The steps are still recorded when they are requested.
+    auto traced = ex.execute(U"key: on", MatchOptions{.fragment = Fragment::Search});
+    CHECK_FALSE(traced.matched);
+    CHECK_FALSE(traced.steps.value().empty());
+
+    // A rejected string reports the algorithm that would have matched it.
+    for (const auto& pattern : {U"[a-z]+=(?:on|off)", U"(?:[a-z]+=(?:on|off)|x*)+;"}) {
+        auto any_regex = Regex(parse_regex(pattern));
+        auto any_ex = Executor(any_regex);
+        for (auto fragment : {Fragment::Whole, Fragment::Search, Fragment::All}) {
+            for (auto algorithm :
+                 {Algorithm::PikeVm,
+                  Algorithm::LazyDfa,
+                  Algorithm::OnePass,
+                  Algorithm::BitParallel}) {
+                auto options = MatchOptions{.fragment = fragment, .algorithm = algorithm};
+                CHECK(
+                    any_ex.execute(U"key: on", options).algorithm
+                    == any_ex.execute(U"key=on;", options).algorithm);
+            }
+        }
+    }
+}
+
+TEST_CASE("Reusing an executor gives the same results as a fresh one") {
+    auto regex = Regex(parse_regex(U"(x+x+)+[yz]|a(?P<mid>b|bbc)*(c+)d"));
+    auto reused = Executor(regex);
+    auto budget = MatchBudget{.max_steps = 10000};
+    CHECK_THROWS_AS(
+        reused.execute(U"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxz!", MatchOptions{.budget = budget}),
+        BudgetExceeded);
+    for (auto string : {U"abbccd", U"xxxxxxxxxxz", U"ad", U"xxy", U"abcd"}) {
+        for (auto algorithm : {Algorithm::Backtracking, Algorithm::PikeVm}) {
+            for (auto memoize : {false, true}) {
+                auto options = MatchOptions{.memoize = memoize, .algorithm = algorithm};
+                auto fresh = Executor(regex);
+                auto expected = fresh.execute(string, options);
+                auto actual = reused.execute(string, options);
+                CHECK(actual.matched == expected.matched);
+                CHECK(actual.captures == expected.captures);
+                CHECK(actual.steps == expected.steps);
+            }
+        }
+    }
+}
+
+TEST_CASE("Matching stops when the budget is exceeded") {
+    auto regex = Regex(parse_regex(U"(x+x+)+[yz]"));
+    auto ex = Executor(regex);
+    auto string = std::u32string(30, U'x');
+
+    auto options = MatchOptions{
+        .record_steps = false,
+        .algorithm = Algorithm::Backtracking,
+        .budget = MatchBudget{.max_steps = 5000},
+    };
+    try {
+        ex.execute(string, options);
+        FAIL("The budget has not been enforced");
+    } catch (const BudgetExceeded& e) {
+        CHECK(e.reason() == BudgetExceeded::Reason::Steps);
+        CHECK(e.statistics().steps > 5000);
+        CHECK(e.statistics().steps <= 5000 + MatchBudget::check_interval);
+        CHECK(e.statistics().max_string_pos == 30);
+    }
+
+    options.budget = MatchBudget{.deadline = std::chrono::steady_clock::now()};
+    CHECK_THROWS_AS(ex.execute(string, options), BudgetExceeded);
+
+    // A budget that suffices does not change the result.
+    options.budget = MatchBudget{.max_steps = 5000, .max_decisions = 5000};
+    CHECK(ex.execute(U"xxxxy", options).matched);
+}
+
+TEST_CASE("Repetitions are not given back when that cannot lead to a match") {
+    auto regex = Regex(parse_regex(U"(?P<number>[0-9]+),|x"));
+    auto ex = Executor(regex);
+    auto string = std::u32string(3000, U'1') + U",";
+    auto options = MatchOptions{
+        .record_steps = false,
+        .fragment = Fragment::Search,
+        .algorithm = Algorithm::Backtracking,
+        .budget = MatchBudget{.max_decisions = 100},
+    };
+    auto result = ex.execute(string, options);
+    CHECK(result.matched);
+    CHECK(
+        result.captures.value().named.at("number").string_span
+        == Span::make_with_length(0, 3000));
+
+    // The steps show every repetition that could be given back.
+    options.record_steps = true;
+    CHECK_THROWS_AS(ex.execute(string, options), BudgetExceeded);
+}
+
+TEST_CASE("Regex set tells which regexes match") {
+    auto patterns = std::vector<std::u32string>();
+    auto strings = std::vector<std::u32string>();
+    for (const auto& [pattern, string] : cross_check_cases) {
+        patterns.push_back(pattern);
+        strings.push_back(string);
+    }
+    auto root_parts = std::vector<wr22::regex_parser::regex::SpannedPart>();
+    for (const auto& pattern : patterns) {
+        root_parts.push_back(parse_regex(pattern));
+    }
+    auto regex_set = RegexSet(std::move(root_parts));
+    REQUIRE(regex_set.size() == patterns.size());
+    auto set_ex = SetExecutor(regex_set);
+
+    for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+        auto options = MatchOptions{.record_steps = false, .fragment = fragment};
+        for (const auto& string : strings) {
+            auto expected = std::vector<size_t>();
+            for (size_t i = 0; i < regex_set.size(); ++i) {
+                if (Executor(regex_set.regex_at(i)).execute(string, options).matched) {
+                    expected.push_back(i);
+                }
+            }
+            auto result = set_ex.execute(string, fragment);
+            CHECK(result.combined);
+            CHECK(result.matched == expected);
+        }
+    }
+}
+
+TEST_CASE("Regex set matches the regexes one by one when its cache thrashes") {
+    auto root_parts = std::vector<wr22::regex_parser::regex::SpannedPart>();
+    root_parts.push_back(parse_regex(U"(?:a|b)*a(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)(?:a|b)"));
+    root_parts.push_back(parse_regex(U"(?:a|b)*"));
+    root_parts.push_back(parse_regex(U"c"));
+    auto regex_set = RegexSet(std::move(root_parts));
+
+    auto string = std::u32string();
+    auto seed = 12345u;
+    for (size_t i = 0; i < 10000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        string.push_back((seed >> 16) % 2 == 0 ? U'a' : U'b');
+    }
+    auto ex = LazyDfaSetExecutor(regex_set, Fragment::Whole, 4096);
+    CHECK(ex.execute(U"abbbbbb").value().matched == std::vector<size_t>{0, 1});
+    CHECK_FALSE(ex.execute(string).has_value());
+
+    auto result = SetExecutor(regex_set).execute(string);
+    auto expected = std::vector<size_t>{1};
+    if (string[string.size() - 7] == U'a') {
+        expected.insert(expected.begin(), 0);
+    }
+    CHECK(result.matched == expected);
+}
+
+TEST_CASE("Batches of strings are matched in parallel in the order given") {
+    auto regex = Regex(parse_regex(U"(?P<word>[a-z]+)(?:,(?P<number>[0-9]+))*"));
+    auto ex = Executor(regex);
+    auto strings = std::vector<std::u32string>();
+    // Long enough in total to be split between threads.
+    for (size_t i = 0; i < 200; ++i) {
+        strings.push_back(U"item" + std::u32string(i % 7 + 400, U'x') + U",12");
+        if (i % 3 == 0) {
+            strings.back() += U",";
+        }
+    }
+    auto string_views = std::vector<std::u32string_view>(strings.begin(), strings.end());
+    auto options = MatchOptions{.record_steps = false};
+
+    for (size_t num_threads : {1, 4}) {
+        auto results = ex.execute_batch(string_views, options, num_threads);
+        REQUIRE(results.size() == strings.size());
+        for (size_t i = 0; i < strings.size(); ++i) {
+            auto expected = Executor(regex).execute(strings[i], options);
+            CHECK(results[i].matched == expected.matched);
+            CHECK(results[i].captures == expected.captures);
+        }
+    }
+
+    // Each string may have options of its own.
+    auto all_options = std::vector<MatchOptions>(strings.size(), options);
+    all_options[0].algorithm = Algorithm::LazyDfa;
+    all_options[1].fragment = Fragment::Search;
+    auto results = ex.execute_batch(string_views, all_options, 4);
+    CHECK(results[0].algorithm == Algorithm::LazyDfa);
+    CHECK(results[1].captures.value().whole.string_span == Span::make_with_length(0, 408));
+    CHECK_THROWS_AS(
+        ex.execute_batch(string_views, std::span(all_options).first(1)),
+        std::invalid_argument);
+
+    // Short batches are matched on the calling thread, which gives the same results.
+    auto short_views = std::span(string_views).first(3);
+    auto short_results = ex.execute_batch(short_views, options, 4);
+    for (size_t i = 0; i < short_views.size(); ++i) {
+        CHECK(short_results[i].captures == Executor(regex).execute(strings[i], options).captures);
+    }
+}
+
+TEST_CASE("Batches rethrow the exceptions of the workers") {
+    auto regex = Regex(parse_regex(U"(x+x+)+[yz]"));
+    auto ex = Executor(regex);
+    auto slow = std::u32string(30, U'x');
+    auto padding = std::u32string(Executor::min_parallel_batch_length, U'-');
+    auto strings = std::vector<std::u32string_view>{U"xxy", slow, U"xxz", padding};
+    auto options = MatchOptions{
+        .record_steps = false,
+        .algorithm = Algorithm::Backtracking,
+        .budget = MatchBudget{.max_steps = 5000},
+    };
+    CHECK_THROWS_AS(ex.execute_batch(strings, options, 2), BudgetExceeded);
+}
+
+TEST_CASE("Lazy DFA split between threads gives the same verdict") {
+    const auto patterns = std::vector<std::u32string>{
+        U"(?:ab|c)*",
+        U"[abc]*a[abc][abc]",
+        U"(?:a|b)*c(?:a|b)*",
+        U"[^c]*cc[^c]*",
+        U"(?:abc)+",
+        U"a+b+c",
+    };
+    auto strings = std::vector<std::u32string>{
+        std::u32string(600, U'a'),
+        std::u32string(300, U'c') + U"cc",
+    };
+    auto seed = 12345u;
+    for (size_t i = 0; i < 20; ++i) {
+        auto string = std::u32string();
+        for (size_t j = 0; j < 600; ++j) {
+            seed = seed * 1103515245u + 12345u;
+            string.push_back(U"abc"[(seed >> 16) % (i < 10 ? 3 : 2)]);
+        }
+        strings.push_back(std::move(string));
+    }
+    strings.push_back(U"abc");
+    for (size_t i = 0; i < 200; ++i) {
+        strings.back() += U"abc";
+    }
+
+    for (const auto& pattern : patterns) {
+        auto regex = Regex(parse_regex(pattern));
+        for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+            auto lazy_dfa = LazyDfaExecutor(regex, fragment);
+            auto parallel = ParallelLazyDfaExecutor(regex, fragment, 50, 8);
+            for (const auto& string : strings) {
+                auto expected = lazy_dfa.execute(string).value().matched;
+                for (size_t num_threads : {2, 3, 7}) {
+                    CHECK(parallel.execute(string, num_threads).value().matched == expected);
+                }
+            }
+        }
+    }
+
+    // The top-level executor splits long strings when allowed to.
+    auto regex = Regex(parse_regex(U"(?:ab)*"));
+    auto string = std::u32string();
+    for (size_t i = 0; i < ParallelLazyDfaExecutor::default_min_chunk_length; ++i) {
+        string += U"ab";
+    }
+    auto options = MatchOptions{.record_steps = false, .record_captures = false, .max_threads = 4};
+    auto result = Executor(regex).execute(string, options);
+    CHECK(result.algorithm == Algorithm::LazyDfa);
+    CHECK(result.matched);
+}
+
+TEST_CASE("Runs of literals are compared at once") {
+    auto regex = Regex(parse_regex(U"(?:error|warning): time(?:out|d)"));
+    const auto& program = regex.program();
+    CHECK(
+        program.literal_runs
+        == std::vector<std::u32string>{U"error", U"warning", U": time", U"out"});
+
+    auto ex = Executor(regex);
+    auto without_steps = MatchOptions{.record_steps = false, .algorithm = Algorithm::Backtracking};
+    auto search = without_steps;
+    search.fragment = Fragment::Search;
+    for (const auto& string :
+         {U"error: timeout", U"warning: timed", U"error: time", U"error: timeouts", U"warn"}) {
+        auto expected = ex.execute(string);
+        CHECK(ex.execute(string, without_steps).matched == expected.matched);
+        auto padded = U"[" + std::u32string(string) + U"]";
+        auto expected_search = ex.execute(padded, MatchOptions{.fragment = Fragment::Search});
+        CHECK(ex.execute(padded, search).captures == expected_search.captures);
+    }
+    CHECK(ex.execute(U"error: timeout", without_steps).matched);
+    CHECK_FALSE(ex.execute(U"error: timeou", without_steps).matched);
+
+    // The steps still show every literal.
+    auto result = ex.execute(U"error: timed");
+    auto num_literal_steps = std::count_if(
+        result.steps.value().begin(),
+        result.steps.value().end(),
+        [](const Step& step) {
+            return std::holds_alternative<wr22::regex_executor::algorithms::backtracking::step::
+                                              MatchLiteral>(step.as_variant());
+        });
+    CHECK(num_literal_steps == 13);
+}
+
+TEST_CASE("Single-character repetitions are matched as a run") {
+    auto cases = std::vector<std::pair<std::u32string, std::u32string>>{
+        {U"(?P<head>.*),(?P<tail>.*)", U"a,b,c,d"},
+        {U"(?P<as>a*)ab", U"aaaab"},
+        {U"(?P<as>a*)ab", U"aaaa"},
+        {U"x(?P<digits>[0-9]+)(?:[0-9]|y)", U"x12345y"},
+        {U"(?P<name>[a-z]+)@(?P<host>[a-z.]+)", U"to: alice@example.org!"},
+        {U"(?:a+b|a+c)*", U"aabaaacab"},
+        {U"(?P<sign>[+-]?)(?P<digits>[0-9]+)", U"-12"},
+        {U"(?P<sign>[+-]?)(?P<digits>[0-9]+)", U"+-12"},
+        {U"(?P<a>a?)a", U"a"},
+        {U"(?P<a>a?)(?P<b>a?)ab", U"aaab"},
+        {U"(?:(?P<x>x?),)*", U"x,,xx,"},
+    };
+    for (const auto& [pattern, string] : cases) {
+        auto regex = Regex(parse_regex(pattern));
+        auto ex = Executor(regex);
+        for (auto fragment : {Fragment::Whole, Fragment::Search}) {
+            auto traced = MatchOptions{.fragment = fragment, .algorithm = Algorithm::Backtracking};
+            auto fast = traced;
+            fast.record_steps = false;
+            auto memoized = fast;
+            memoized.memoize = true;
+            auto expected = ex.execute(string, traced);
+            CHECK(ex.execute(string, fast).captures == expected.captures);
+            CHECK(ex.execute(string, memoized).captures == expected.captures);
+        }
+    }
+
+    // Neither walking through a long run nor giving it back costs an instruction per character.
+    auto regex = Regex(parse_regex(U"(?P<prefix>.*)foo"));
+    auto ex = Executor(regex);
+    auto string = std::u32string(100000, U'a') + U"foo" + std::u32string(100000, U'b');
+    auto options = MatchOptions{
+        .record_steps = false,
+        .fragment = Fragment::Search,
+        .algorithm = Algorithm::Backtracking,
+        .budget = MatchBudget{.max_steps = 1000},
+    };
+    auto result = ex.execute(string, options);
+    REQUIRE(result.captures.has_value());
+    CHECK(
+        result.captures.value().named.at("prefix").string_span
+        == Span::make_from_positions(0, 100000));
+}
+
+TEST_CASE("Run lengths are the same with every instruction set") {
+    using Range = CompiledCharClass::Range;
+    auto classes = std::vector<std::vector<Range>>{
+        {{.first = U'0', .last = U'9'}},
+        {{.first = U'\t', .last = U'\n'}, {.first = U' ', .last = U' '}},
+        {{.first = U'+', .last = U'+'},
+         {.first = U'/', .last = U'9'},
+         {.first = U'A', .last = U'Z'},
+         {.first = U'a', .last = U'z'}},
+        {{.first = U'\u0410', .last = U'\u044f'}, {.first = 0x10000, .last = 0x10ffff}},
+        {{.first = 0, .last = U'a'}, {.first = U'c', .last = 0xffffffff}},
+        {},
+    };
+    auto alphabet = std::u32string(U"09az+/AZ \t\n\u0430b\U0001f600");
+    auto levels = std::vector<SimdLevel>{SimdLevel::Scalar};
+    if (supported_simd_level() != SimdLevel::Scalar) {
+        levels.push_back(SimdLevel::Sse2);
+    }
+    if (supported_simd_level() == SimdLevel::Avx2) {
+        levels.push_back(SimdLevel::Avx2);
+    }
+
+    for (const auto& ranges : classes) {
+        auto char_class = CompiledCharClass(ranges);
+        auto members = std::u32string();
+        std::copy_if(
+            alphabet.begin(),
+            alphabet.end(),
+            std::back_inserter(members),
+            [&char_class](char32_t c) { return char_class.matches(c); });
+        if (members.empty()) {
+            members = alphabet;
+        }
+        // Stop the run at every position of the vectors and of the tail after them.
+        for (auto stop : alphabet) {
+            for (size_t length = 0; length < 40; ++length) {
+                auto string = std::u32string();
+                for (size_t i = 0; i < length; ++i) {
+                    string.push_back(members.at(i % members.size()));
+                }
+                string.push_back(stop);
+                auto expected = static_cast<size_t>(
+                    std::find_if(
+                        string.begin(),
+                        string.end(),
+                        [&char_class](char32_t c) { return !char_class.matches(c); })
+                    - string.begin());
+                for (auto level : levels) {
+                    CHECK(ranges_run_length(string, char_class.ranges(), level) == expected);
+                }
+                CHECK(class_run_length(string, char_class) == expected);
+            }
+        }
+    }
+
+    auto digits = std::u32string(1000, U'7') + U"x";
+    CHECK(literal_run_length(digits, U'7') == 1000);
+    CHECK(literal_run_length(digits, U'8') == 0);
+}
+
+TEST_CASE("Literals are found where std::u32string_view::find finds them") {
+    auto literals = std::vector<std::u32string>{
+        U"",
+        U"a",
+        U"ab",
+        U"aab",
+        U"\U0001f600b",
+        std::u32string(1, U'\0'),
+        std::u32string(1, 0xffffffff),
+    };
+    auto alphabet = std::u32string(U"ab\U0001f600");
+    alphabet.push_back(U'\0');
+    alphabet.push_back(0xffffffff);
+    // Strings of every length up to past two AVX2 vectors, with the literal ending at every
+    // position or missing.
+    for (const auto& literal : literals) {
+        for (size_t length = 0; length < 20; ++length) {
+            for (size_t seed = 0; seed < 8; ++seed) {
+                auto string = std::u32string();
+                for (size_t i = 0; i < length; ++i) {
+                    string.push_back(alphabet.at((i * 7 + seed * 3 + i / 3) % alphabet.size()));
+                }
+                for (size_t from = 0; from <= length + 1; ++from) {
+                    auto view = std::u32string_view(string);
+                    CHECK(find_literal(view, literal, from) == view.find(literal, from));
+                }
+                string.replace(length / 2, 0, literal);
+                auto view = std::u32string_view(string);
+                for (size_t from = 0; from <= string.size() + 1; ++from) {
+                    CHECK(find_literal(view, literal, from) == view.find(literal, from));
+                }
+            }
+        }
+    }
+
+    auto haystack = std::u32string(1000, U'a') + U"ab";
+    CHECK(find_literal(haystack, U"ab") == 1000);
+    CHECK(find_literal(haystack, U"b", 1001) == 1001);
+    CHECK(find_literal(haystack, U"ba") == std::u32string_view::npos);
+}
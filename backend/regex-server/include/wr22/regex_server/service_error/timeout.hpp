@@ -0,0 +1,11 @@
+#pragma once
+#include <wr22/regex_server/service_error.hpp>
+
+namespace wr22::regex_server::service_error {
+
+constexpr const char timeout_code[] = "timeout";
+
+/// A service error that indicates that handling the request would take too much time or memory.
+class Timeout : public StaticServiceError<timeout_code, 503> {};
+
+}// namespace wr22::regex_server::service_error
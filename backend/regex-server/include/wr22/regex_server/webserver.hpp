@@ -22,6 +22,7 @@ private:
     nlohmann::json parse_handler(const crow::request& request, crow::response& response);
     nlohmann::json explain_handler(const crow::request& request, crow::response& response);
     nlohmann::json match_handler(const crow::request& request, crow::response& response);
+    nlohmann::json match_set_handler(const crow::request& request, crow::response& response);
 
     crow::SimpleApp m_app;
 };
@@ -1,6 +1,13 @@
 // wr22
+#include <wr22/regex_executor/algorithm.hpp>
+#include <wr22/regex_executor/algorithms/backtracking/step_log.hpp>
 #include <wr22/regex_executor/executor.hpp>
+#include <wr22/regex_executor/fragment.hpp>
+#include <wr22/regex_executor/match_budget.hpp>
+#include <wr22/regex_executor/match_options.hpp>
 #include <wr22/regex_executor/regex.hpp>
+#include <wr22/regex_executor/regex_set.hpp>
+#include <wr22/regex_executor/set_executor.hpp>
 #include <wr22/regex_explainer/explanation/explanation.hpp>
 #include <wr22/regex_explainer/hints/hint.hpp>
 #include <wr22/regex_parser/parser/errors.hpp>
@@ -11,15 +18,21 @@
 #include <wr22/regex_server/service_error/invalid_request_json.hpp>
 #include <wr22/regex_server/service_error/invalid_request_json_structure.hpp>
 #include <wr22/regex_server/service_error/invalid_utf8.hpp>
-#include <wr22/regex_server/service_error/not_implemented.hpp>
+#include <wr22/regex_server/service_error/timeout.hpp>
 #include <wr22/regex_server/webserver.hpp>
 #include <wr22/unicode/conversion.hpp>
 
 // stl
+#include <chrono>
+#include <cstddef>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
 
 // crow
 #include <crow.h>
@@ -36,6 +49,14 @@
 namespace wr22::regex_server {
 
 namespace {
+    /// The time a `/match` or `/match_set` request may spend matching its strings.
+    constexpr auto match_time_limit = std::chrono::seconds(10);
+    /// The memory matching one string may use, in bytes.
+    constexpr size_t match_memory_limit = 1024 * 1024 * 1024;
+    /// The number of threads one `/match` request may match its strings on. The server already
+    /// handles the requests on several threads, so a request only takes a few more.
+    constexpr size_t match_max_threads = 4;
+
     /// Pointer to member of `Webserver`.
     using HandlerPtr =
         nlohmann::json (Webserver::*)(const crow::request& request, crow::response& response);
@@ -174,6 +195,60 @@ namespace {
         }
         throw service_error::InvalidRequestJsonStructure{};
     }
+
+    /// Get an optional boolean field of a JSON object, falling back to `default_value` if it is
+    /// absent.
+    bool optional_json_bool_at(const nlohmann::json& json, const char* key, bool default_value) {
+        if (!json.is_object()) {
+            throw service_error::InvalidRequestJsonStructure{};
+        }
+        auto it = json.find(key);
+        if (it == json.end()) {
+            return default_value;
+        }
+        if (!it->is_boolean()) {
+            throw service_error::InvalidRequestJsonStructure{};
+        }
+        return it->get<bool>();
+    }
+
+    /// Get an optional string field of a JSON object, or `std::nullopt` if it is absent.
+    std::optional<std::string> optional_json_string_at(
+        const nlohmann::json& json,
+        const char* key) {
+        if (!json.is_object()) {
+            throw service_error::InvalidRequestJsonStructure{};
+        }
+        auto it = json.find(key);
+        if (it == json.end()) {
+            return std::nullopt;
+        }
+        return extract_json_string(*it);
+    }
+
+    /// Get the algorithm named by an optional field of a JSON object, or `std::nullopt` if it is
+    /// absent and the planner has to choose.
+    std::optional<regex_executor::Algorithm> algorithm_at(
+        const nlohmann::json& json,
+        const char* key) {
+        auto name = optional_json_string_at(json, key);
+        if (!name.has_value()) {
+            return std::nullopt;
+        }
+        auto algorithm = regex_executor::algorithm_from_name(name.value());
+        if (!algorithm.has_value()) {
+            throw service_error::InvalidRequestJsonStructure{};
+        }
+        return algorithm.value();
+    }
+
+    regex_executor::Fragment fragment_at(const nlohmann::json& json, const char* key) {
+        auto fragment = regex_executor::fragment_from_name(extract_json_string(json_at(json, key)));
+        if (!fragment.has_value()) {
+            throw service_error::InvalidRequestJsonStructure{};
+        }
+        return fragment.value();
+    }
 }  // namespace
 
 Webserver::Webserver() {
@@ -183,6 +258,8 @@ Webserver::Webserver() {
         .methods(crow::HTTPMethod::POST)(handle_errors_in(*this, &Webserver::explain_handler));
     CROW_ROUTE(m_app, "/match")
         .methods(crow::HTTPMethod::POST)(handle_errors_in(*this, &Webserver::match_handler));
+    CROW_ROUTE(m_app, "/match_set")
+        .methods(crow::HTTPMethod::POST)(handle_errors_in(*this, &Webserver::match_set_handler));
 }
 
 void Webserver::run() {
@@ -210,6 +287,17 @@ nlohmann::json Webserver::match_handler(const crow::request& request, crow::resp
     if (!json_strings.is_array()) {
         throw service_error::InvalidRequestJson{};
     }
+    auto match_options = regex_executor::MatchOptions{
+        .record_steps = optional_json_bool_at(request_json, "trace", true),
+        .memoize = optional_json_bool_at(request_json, "memoize", false),
+        .record_captures = optional_json_bool_at(request_json, "captures", true),
+        .algorithm = algorithm_at(request_json, "algorithm"),
+        .budget =
+            regex_executor::MatchBudget{
+                .max_memory = match_memory_limit,
+                .deadline = std::chrono::steady_clock::now() + match_time_limit,
+            },
+    };
 
     // TODO: handle parse errors.
     return parse_regex(regex_string)
@@ -222,17 +310,46 @@ nlohmann::json Webserver::match_handler(const crow::request& request, crow::resp
                 match_results = nlohmann::json::array();
                 auto executor = regex_executor::Executor(regex);
 
+                auto strings = std::vector<std::u32string>();
+                auto string_match_options = std::vector<regex_executor::MatchOptions>();
                 for (const auto& json_string_spec : json_strings) {
-                    auto string = decode_json_string(json_at(json_string_spec, "string"));
-                    auto fragment_string = extract_json_string(
-                        json_at(json_string_spec, "fragment"));
-                    if (fragment_string != "whole") {
-                        // STUB.
-                        throw service_error::NotImplemented{};
-                    }
+                    strings.push_back(decode_json_string(json_at(json_string_spec, "string")));
+                    string_match_options.push_back(match_options);
+                    string_match_options.back().fragment =
+                        fragment_at(json_string_spec, "fragment");
+                }
 
-                    auto result = executor.execute(string);
-                    match_results.push_back(std::move(result));
+                // The planner always chooses backtracking to record the steps.
+                auto algorithm =
+                    match_options.algorithm.value_or(regex_executor::Algorithm::Backtracking);
+                try {
+                    if (algorithm == regex_executor::Algorithm::Backtracking
+                        && match_options.record_steps) {
+                        // Keep the steps packed until they are serialized. The steps take far
+                        // more memory than the matching itself, so the strings are matched one
+                        // at a time.
+                        for (size_t i = 0; i < strings.size(); ++i) {
+                            auto step_log = regex_executor::algorithms::backtracking::StepLog();
+                            auto result =
+                                executor.execute(strings[i], string_match_options[i], step_log);
+                            auto result_json = nlohmann::json(std::move(result));
+                            result_json["steps"] = step_log;
+                            match_results.push_back(std::move(result_json));
+                        }
+                    } else {
+                        auto string_views =
+                            std::vector<std::u32string_view>(strings.begin(), strings.end());
+                        auto results = executor.execute_batch(
+                            string_views,
+                            string_match_options,
+                            match_max_threads);
+                        for (auto& result : results) {
+                            match_results.push_back(std::move(result));
+                        }
+                    }
+                } catch (const regex_executor::BudgetExceeded& e) {
+                    SPDLOG_WARN("Matching stopped: {}", e.what());
+                    throw service_error::Timeout{};
                 }
                 return response_json;
             },
@@ -243,6 +360,58 @@ nlohmann::json Webserver::match_handler(const crow::request& request, crow::resp
             });
 }
 
+nlohmann::json Webserver::match_set_handler(
+    const crow::request& request,
+    crow::response& response) {
+    const auto request_json = nlohmann::json::parse(request.body, nullptr, false);
+    if (request_json.is_discarded()) {
+        throw service_error::InvalidRequestJson{};
+    }
+
+    auto json_regexes = json_at(request_json, "regexes");
+    auto json_strings = json_at(request_json, "strings");
+    if (!json_regexes.is_array() || !json_strings.is_array()) {
+        throw service_error::InvalidRequestJson{};
+    }
+
+    auto root_parts = std::vector<regex_parser::regex::SpannedPart>();
+    for (size_t regex_index = 0; regex_index < json_regexes.size(); ++regex_index) {
+        auto regex_string = decode_json_string(json_regexes[regex_index]);
+        auto parse_result = parse_regex(regex_string);
+        if (auto* failure = std::get_if<ParseFailure>(&parse_result.as_variant())) {
+            // Report the first regex that could not be parsed.
+            auto response_json = nlohmann::json::object();
+            response_json["parse_error"] = std::move(failure->parse_error);
+            response_json["regex_index"] = regex_index;
+            return response_json;
+        }
+        root_parts.push_back(std::get<ParseSuccess>(std::move(parse_result.as_variant())).part);
+    }
+
+    // The same limits as for `/match`, applied when the regexes are matched one by one.
+    auto budget = regex_executor::MatchBudget{
+        .max_memory = match_memory_limit,
+        .deadline = std::chrono::steady_clock::now() + match_time_limit,
+    };
+
+    auto regex_set = regex_executor::RegexSet(std::move(root_parts));
+    auto executor = regex_executor::SetExecutor(regex_set);
+    auto response_json = nlohmann::json::object();
+    auto& match_results = response_json["match_results"];
+    match_results = nlohmann::json::array();
+    try {
+        for (const auto& json_string_spec : json_strings) {
+            auto string = decode_json_string(json_at(json_string_spec, "string"));
+            auto fragment = fragment_at(json_string_spec, "fragment");
+            match_results.push_back(executor.execute(string, fragment, budget));
+        }
+    } catch (const regex_executor::BudgetExceeded& e) {
+        SPDLOG_WARN("Matching stopped: {}", e.what());
+        throw service_error::Timeout{};
+    }
+    return response_json;
+}
+
 nlohmann::json Webserver::explain_handler(
     [[maybe_unused]] const crow::request& request,
     crow::response& response) {